@@ -14,13 +14,19 @@ install(
     DIRECTORY
         ${CMAKE_SOURCE_DIR}/shaders
         ${CMAKE_SOURCE_DIR}/textures
-        ${CMAKE_SOURCE_DIR}/levels
         ${CMAKE_SOURCE_DIR}/audio
         ${CMAKE_SOURCE_DIR}/fonts
     DESTINATION ${BREAKOUT_INSTALL_ROOT}
     COMPONENT ${BREAKOUT_EXECUTABLE_COMPONENT}
 )
 
+# Levels, converted by the build
+install(
+    DIRECTORY $<TARGET_FILE_DIR:Breakout_exe>/levels
+    DESTINATION ${BREAKOUT_INSTALL_ROOT}
+    COMPONENT ${BREAKOUT_EXECUTABLE_COMPONENT}
+)
+
 # Dependencies (.dll)
 if (WIN32)
     # MSVC runtime libs
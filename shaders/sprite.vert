@@ -1,13 +1,27 @@
 #version 330 core
 layout (location = 0) in vec4 vertex; // <vec2 position, vec2 texCoords>
+// per-instance attributes, see SpriteInstance
+layout (location = 1) in vec4 rect; // <vec2 position, vec2 size>
+layout (location = 2) in vec4 colorRotation; // <vec3 color, float degrees>
+layout (location = 3) in vec4 texRect; // <vec2 uv offset, vec2 uv scale>
 
 out vec2 TexCoords;
+out vec3 SpriteColor;
 
-uniform mat4 model;
 uniform mat4 projection;
 
 void main()
 {
-    TexCoords = vertex.zw;
-    gl_Position = projection * model * vec4(vertex.xy, 0.0, 1.0);
-}
\ No newline at end of file
+    // scale, then rotate around the center of the quad, then translate
+    vec2 size = rect.zw;
+    vec2 local = vertex.xy * size - 0.5 * size;
+    float angle = radians(colorRotation.w);
+    float s = sin(angle);
+    float c = cos(angle);
+    vec2 rotated = vec2(c * local.x - s * local.y, s * local.x + c * local.y);
+    vec2 world = rect.xy + 0.5 * size + rotated;
+
+    TexCoords = texRect.xy + vertex.zw * texRect.zw;
+    SpriteColor = colorRotation.rgb;
+    gl_Position = projection * vec4(world, 0.0, 1.0);
+}
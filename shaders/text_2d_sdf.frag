@@ -0,0 +1,15 @@
+#version 330 core
+in vec2 TexCoords;
+in vec3 TextColor;
+out vec4 color;
+
+uniform sampler2D text; // signed distance field, 0.5 on the outline
+
+void main()
+{
+    float distance = texture(text, TexCoords).r;
+    // antialias over about one screen pixel, whatever the text's scale
+    float width = max(fwidth(distance) * 0.75, 1e-4);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    color = vec4(TextColor, alpha);
+}
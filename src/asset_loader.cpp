@@ -0,0 +1,212 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "asset_loader.h"
+
+#include <algorithm>
+#include <chrono>
+#include <ostream>
+
+namespace
+{
+// Seconds on a monotonic clock
+double now()
+{
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+}  // namespace
+
+struct AssetHandle::State
+{
+  std::string Name;
+  // written and read by the polling thread only
+  bool Ready = false;
+  std::exception_ptr Error;
+};
+
+struct AssetLoader::Job
+{
+  std::shared_ptr<AssetHandle::State> State;
+  std::function<void()> Work;
+  std::function<void()> Finish;
+  // set by the worker; Finish is skipped when Work failed
+  std::exception_ptr Error;
+  double Queued = 0.0;
+  double Started = 0.0;
+  double Worked = 0.0;
+};
+
+AssetHandle::AssetHandle(std::shared_ptr<State> shared, AssetLoader& owner)
+    : state(std::move(shared))
+    , loader(&owner)
+{
+}
+
+const std::string& AssetHandle::Name() const
+{
+  return this->state->Name;
+}
+
+bool AssetHandle::Ready() const
+{
+  return this->state && this->state->Ready;
+}
+
+void AssetHandle::Wait() const
+{
+  this->loader->Wait(*this);
+}
+
+AssetLoader::AssetLoader(unsigned int threads)
+{
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  for (unsigned int i = 0; i < threads; ++i)
+    this->workers.emplace_back([this] { this->runWorker(); });
+}
+
+AssetLoader::~AssetLoader()
+{
+  {
+    std::lock_guard lock(this->mutex);
+    this->stopping = true;
+  }
+  this->jobQueued.notify_all();
+  for (std::thread& worker : this->workers)
+    worker.join();
+}
+
+AssetHandle AssetLoader::enqueue(std::string name,
+                                 std::function<void()> work,
+                                 std::function<void()> finish)
+{
+  auto job = std::make_unique<Job>();
+  job->State = std::make_shared<AssetHandle::State>();
+  job->State->Name = std::move(name);
+  job->Work = std::move(work);
+  job->Finish = std::move(finish);
+  job->Queued = now();
+  if (this->firstRequest < 0.0)
+    this->firstRequest = job->Queued;
+  AssetHandle handle(job->State, *this);
+  {
+    std::lock_guard lock(this->mutex);
+    this->queued.push_back(std::move(job));
+  }
+  ++this->unfinished;
+  this->jobQueued.notify_one();
+  return handle;
+}
+
+void AssetLoader::runWorker()
+{
+  for (;;) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock lock(this->mutex);
+      this->jobQueued.wait(
+          lock, [this] { return this->stopping || !this->queued.empty(); });
+      if (this->stopping)
+        return;
+      job = std::move(this->queued.front());
+      this->queued.pop_front();
+    }
+    job->Started = now();
+    try {
+      job->Work();
+    } catch (...) {
+      job->Error = std::current_exception();
+    }
+    job->Worked = now();
+    {
+      std::lock_guard lock(this->mutex);
+      this->done.push_back(std::move(job));
+    }
+    this->jobDone.notify_all();
+  }
+}
+
+void AssetLoader::complete(Job& job)
+{
+  const double start = now();
+  if (!job.Error) {
+    try {
+      job.Finish();
+    } catch (...) {
+      job.Error = std::current_exception();
+    }
+  }
+  const double end = now();
+  job.State->Error = job.Error;
+  job.State->Ready = true;
+  if (job.Error && !this->firstError)
+    this->firstError = job.Error;
+  --this->unfinished;
+  this->lastFinish = end;
+  this->timings.push_back(AssetTiming {job.State->Name,
+                                       job.Started - job.Queued,
+                                       job.Worked - job.Started,
+                                       end - start});
+}
+
+unsigned int AssetLoader::Poll()
+{
+  std::deque<std::unique_ptr<Job>> finished;
+  {
+    std::lock_guard lock(this->mutex);
+    finished.swap(this->done);
+  }
+  for (const auto& job : finished)
+    this->complete(*job);
+  return static_cast<unsigned int>(finished.size());
+}
+
+void AssetLoader::Wait(const AssetHandle& handle)
+{
+  while (!handle.Ready()) {
+    if (this->Poll() > 0)
+      continue;
+    std::unique_lock lock(this->mutex);
+    this->jobDone.wait(lock, [this] { return !this->done.empty(); });
+  }
+  if (handle.state->Error)
+    std::rethrow_exception(handle.state->Error);
+}
+
+void AssetLoader::WaitAll()
+{
+  while (this->unfinished > 0) {
+    if (this->Poll() > 0)
+      continue;
+    std::unique_lock lock(this->mutex);
+    this->jobDone.wait(lock, [this] { return !this->done.empty(); });
+  }
+  if (this->firstError)
+    std::rethrow_exception(std::exchange(this->firstError, nullptr));
+}
+
+void AssetLoader::Report(std::ostream& out) const
+{
+  double work = 0.0;
+  double finish = 0.0;
+  for (const AssetTiming& timing : this->timings) {
+    out << "asset " << timing.Name << ": " << timing.Work * 1000.0
+        << " ms loading, " << timing.Finish * 1000.0
+        << " ms on the main thread, " << timing.Queued * 1000.0
+        << " ms queued\n";
+    work += timing.Work;
+    finish += timing.Finish;
+  }
+  const double total =
+      this->timings.empty() ? 0.0 : this->lastFinish - this->firstRequest;
+  out << "assets: " << this->timings.size() << " in " << total * 1000.0
+      << " ms on " << this->Threads() << " threads (" << work * 1000.0
+      << " ms loading, " << finish * 1000.0 << " ms on the main thread)\n";
+}
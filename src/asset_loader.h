@@ -0,0 +1,139 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+class AssetLoader;
+
+// How long one asset took, in seconds: waiting for a free worker, being read
+// and decoded on the worker, and being finished (uploaded) on the thread that
+// owns the GL context
+struct AssetTiming
+{
+  std::string Name;
+  double Queued = 0.0;
+  double Work = 0.0;
+  double Finish = 0.0;
+};
+
+// Refers to an asset requested from an AssetLoader. Like a future it turns
+// ready once, and Wait() reports the error of a failed load; the loaded
+// resource itself is retrieved by name from whoever stores it.
+class AssetHandle
+{
+public:
+  AssetHandle() = default;
+
+  const std::string& Name() const;
+  // Whether the asset is loaded or failed to load
+  bool Ready() const;
+  // Finishes loaded assets until this one is ready; rethrows its error. Only
+  // call on the thread that polls the loader.
+  void Wait() const;
+
+private:
+  friend class AssetLoader;
+  struct State;
+
+  AssetHandle(std::shared_ptr<State> shared, AssetLoader& owner);
+
+  std::shared_ptr<State> state;
+  AssetLoader* loader = nullptr;
+};
+
+// AssetLoader runs the slow part of loading assets - reading files, decoding
+// images and sounds - on a pool of worker threads, so assets load side by
+// side instead of one after another. What has to happen on the thread that
+// owns the GL context, like creating textures, is done when that thread calls
+// Poll() or one of the Wait functions.
+class AssetLoader
+{
+public:
+  // Starts the given number of workers; 0 starts one per hardware thread
+  explicit AssetLoader(unsigned int threads = 0);
+  // Waits for the workers to finish their current job; jobs that haven't
+  // started are dropped
+  ~AssetLoader();
+
+  AssetLoader(const AssetLoader&) = delete;
+  AssetLoader& operator=(const AssetLoader&) = delete;
+
+  // Calls work() on a worker, then finish(result) on the polling thread. An
+  // exception thrown by either fails the asset.
+  template<typename Work, typename Finish>
+  AssetHandle Load(std::string name, Work work, Finish finish)
+  {
+    using Result = std::invoke_result_t<Work&>;
+    auto result = std::make_shared<std::optional<Result>>();
+    return this->enqueue(
+        std::move(name),
+        [work = std::move(work), result]() mutable { result->emplace(work()); },
+        [finish = std::move(finish), result]() mutable
+        { finish(std::move(**result)); });
+  }
+
+  // Finishes the assets whose work is done, without blocking; returns how
+  // many were finished
+  unsigned int Poll();
+  // Finishes assets until handle is ready; rethrows its error
+  void Wait(const AssetHandle& handle);
+  // Finishes all requested assets; then rethrows the first error, if any
+  void WaitAll();
+
+  // Number of workers
+  unsigned int Threads() const
+  {
+    return static_cast<unsigned int>(workers.size());
+  }
+  // Timings of the finished assets, in the order they finished
+  const std::vector<AssetTiming>& Timings() const { return timings; }
+  // Prints the timings and how long loading took in total
+  void Report(std::ostream& out) const;
+
+private:
+  struct Job;
+
+  AssetHandle enqueue(std::string name,
+                      std::function<void()> work,
+                      std::function<void()> finish);
+  // Runs finish for a job that left the workers
+  void complete(Job& job);
+  void runWorker();
+
+  std::vector<std::thread> workers;
+  std::mutex mutex;
+  std::condition_variable jobQueued;
+  std::condition_variable jobDone;
+  // guarded by mutex
+  std::deque<std::unique_ptr<Job>> queued;
+  std::deque<std::unique_ptr<Job>> done;
+  bool stopping = false;
+  // only touched by the polling thread
+  unsigned int unfinished = 0;
+  std::exception_ptr firstError;
+  std::vector<AssetTiming> timings;
+  double firstRequest = -1.0;
+  double lastFinish = 0.0;
+};
+
+#endif
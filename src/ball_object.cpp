@@ -19,11 +19,9 @@ BallObject::BallObject()
 
 BallObject::BallObject(glm::vec2 pos,
                        float radius,
-                       glm::vec2 velocity,
-                       Texture2D sprite)
+                       glm::vec2 velocity)
     : GameObject(pos,
                  glm::vec2(radius * 2.0f, radius * 2.0f),
-                 sprite,
                  glm::vec3(1.0f),
                  velocity)
     , Radius(radius)
@@ -33,29 +31,6 @@ BallObject::BallObject(glm::vec2 pos,
 {
 }
 
-glm::vec2 BallObject::Move(float dt, unsigned int window_width)
-{
-  // if not stuck to player board
-  if (!this->Stuck) {
-    // move the ball
-    this->Position += this->Velocity * dt;
-    // then check if outside window bounds and if so, reverse velocity and
-    // restore at correct position
-    if (this->Position.x <= 0.0f) {
-      this->Velocity.x = -this->Velocity.x;
-      this->Position.x = 0.0f;
-    } else if (this->Position.x + this->Size.x >= window_width) {
-      this->Velocity.x = -this->Velocity.x;
-      this->Position.x = window_width - this->Size.x;
-    }
-    if (this->Position.y <= 0.0f) {
-      this->Velocity.y = -this->Velocity.y;
-      this->Position.y = 0.0f;
-    }
-  }
-  return this->Position;
-}
-
 // resets the ball to initial Stuck Position (if ball is outside window bounds)
 void BallObject::Reset(glm::vec2 position, glm::vec2 velocity)
 {
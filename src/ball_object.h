@@ -10,9 +10,7 @@
 #define BALLOBJECT_H
 
 #include "game_object.h"
-#include "texture.h"
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 // BallObject holds the state of the Ball object inheriting
@@ -28,10 +26,7 @@ public:
   bool Sticky, PassThrough;
   // constructor(s)
   BallObject();
-  BallObject(glm::vec2 pos, float radius, glm::vec2 velocity, Texture2D sprite);
-  // moves the ball, keeping it constrained within the window bounds (except
-  // bottom edge); returns new position
-  glm::vec2 Move(float dt, unsigned int window_width);
+  BallObject(glm::vec2 pos, float radius, glm::vec2 velocity);
   // resets the ball to original state with given position and velocity
   void Reset(glm::vec2 position, glm::vec2 velocity);
 };
@@ -0,0 +1,74 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// BitSet is a run-time sized set of bits packed into 64-bit words, for
+// per-object flags that are cleared or counted all at once: both touch one
+// word per 64 objects.
+class BitSet
+{
+public:
+  BitSet() = default;
+  explicit BitSet(std::size_t size) { this->Resize(size); }
+
+  // Changes the number of bits; all of them are cleared
+  void Resize(std::size_t size)
+  {
+    this->count = size;
+    this->words.assign((size + 63) / 64, 0);
+  }
+  std::size_t Size() const { return count; }
+
+  bool Test(std::size_t bit) const
+  {
+    return (this->words[bit / 64] >> (bit % 64) & 1u) != 0;
+  }
+  void Set(std::size_t bit) { this->words[bit / 64] |= mask(bit); }
+  void Clear(std::size_t bit) { this->words[bit / 64] &= ~mask(bit); }
+  // Clears every bit
+  void ClearAll() { std::fill(this->words.begin(), this->words.end(), 0); }
+  // Sets every bit
+  void SetAll()
+  {
+    std::fill(this->words.begin(), this->words.end(), ~std::uint64_t {0});
+    // keep the bits past the end clear, for Count()
+    if (this->count % 64 != 0)
+      this->words.back() = mask(this->count) - 1;
+  }
+
+  // Number of set bits
+  std::size_t Count() const
+  {
+    std::size_t total = 0;
+    for (std::uint64_t word : this->words)
+      total += static_cast<std::size_t>(std::popcount(word));
+    return total;
+  }
+
+  std::span<const std::uint64_t> Words() const { return words; }
+
+private:
+  static std::uint64_t mask(std::size_t bit)
+  {
+    return std::uint64_t {1} << (bit % 64);
+  }
+
+  std::vector<std::uint64_t> words;
+  std::size_t count = 0;
+};
+
+#endif
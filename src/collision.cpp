@@ -0,0 +1,136 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+// Overlaps shallower than this count as touching, so a circle placed exactly
+// on a surface isn't pushed out again because of rounding
+constexpr float contactSlop = 1.0e-3f;
+
+// Range of times [Enter, Exit] during which a moving point is inside a slab
+struct Interval
+{
+  float Enter;
+  float Exit;
+};
+
+Interval slab(float origin, float motion, float lo, float hi)
+{
+  constexpr float infinity = std::numeric_limits<float>::infinity();
+  if (std::fpclassify(motion) == FP_ZERO) {
+    if (origin < lo || origin > hi)
+      return {infinity, -infinity};
+    return {-infinity, infinity};
+  }
+  const float t0 = (lo - origin) / motion;
+  const float t1 = (hi - origin) / motion;
+  return {std::min(t0, t1), std::max(t0, t1)};
+}
+
+// Outward normal of the box face closest to a point inside the box
+glm::vec2 nearestFaceNormal(glm::vec2 point, glm::vec2 boxMin, glm::vec2 boxMax)
+{
+  float nearest = point.x - boxMin.x;
+  glm::vec2 normal(-1.0f, 0.0f);
+  if (boxMax.x - point.x < nearest) {
+    nearest = boxMax.x - point.x;
+    normal = glm::vec2(1.0f, 0.0f);
+  }
+  if (point.y - boxMin.y < nearest) {
+    nearest = point.y - boxMin.y;
+    normal = glm::vec2(0.0f, -1.0f);
+  }
+  if (boxMax.y - point.y < nearest)
+    normal = glm::vec2(0.0f, 1.0f);
+  return normal;
+}
+
+// Sweeps a circle against a single point (a corner of a box)
+std::optional<SweepHit> sweepCorner(glm::vec2 center,
+                                    float radius,
+                                    glm::vec2 motion,
+                                    glm::vec2 corner)
+{
+  // solve |center + motion * t - corner| = radius for the first t
+  const glm::vec2 toCenter = center - corner;
+  const float a = glm::dot(motion, motion);
+  const float halfB = glm::dot(motion, toCenter);
+  const float c = glm::dot(toCenter, toCenter) - radius * radius;
+  if (halfB >= 0.0f)  // not approaching the corner
+    return std::nullopt;
+  const float discriminant = halfB * halfB - a * c;
+  if (discriminant < 0.0f)  // passes by
+    return std::nullopt;
+  const float t = (-halfB - std::sqrt(discriminant)) / a;
+  if (t > 1.0f)
+    return std::nullopt;
+  const float time = std::max(t, 0.0f);
+  return SweepHit {time, glm::normalize(center + motion * time - corner)};
+}
+}  // namespace
+
+std::optional<SweepHit> SweepCircleAabb(glm::vec2 center,
+                                        float radius,
+                                        glm::vec2 motion,
+                                        glm::vec2 boxMin,
+                                        glm::vec2 boxMax)
+{
+  // already overlapping: push out along the shortest way
+  const glm::vec2 closest = glm::clamp(center, boxMin, boxMax);
+  const glm::vec2 offset = center - closest;
+  const float distance = glm::length(offset);
+  if (distance < radius - contactSlop) {
+    const glm::vec2 normal = distance > 0.0f
+        ? offset / distance
+        : nearestFaceNormal(center, boxMin, boxMax);
+    if (glm::dot(motion, normal) < 0.0f)
+      return SweepHit {0.0f, normal};
+    return std::nullopt;
+  }
+
+  // otherwise trace the center against the box grown by the radius
+  const Interval x =
+      slab(center.x, motion.x, boxMin.x - radius, boxMax.x + radius);
+  const Interval y =
+      slab(center.y, motion.y, boxMin.y - radius, boxMax.y + radius);
+  const float enter = std::max(x.Enter, y.Enter);
+  const float exit = std::min(x.Exit, y.Exit);
+  if (enter > exit || exit < 0.0f || enter > 1.0f)
+    return std::nullopt;
+  // starting inside the grown box without overlapping means touching
+  if (enter < 0.0f && distance <= radius) {
+    const glm::vec2 normal = offset / distance;
+    if (glm::dot(motion, normal) < 0.0f)
+      return SweepHit {0.0f, normal};
+    return std::nullopt;
+  }
+
+  // the grown box has rounded corners: beyond both extents of the box, the
+  // circle touches the corner point rather than a face
+  const glm::vec2 contact = center + motion * std::max(enter, 0.0f);
+  const bool beyondX = contact.x < boxMin.x || contact.x > boxMax.x;
+  const bool beyondY = contact.y < boxMin.y || contact.y > boxMax.y;
+  if (beyondX && beyondY) {
+    const glm::vec2 corner(contact.x < boxMin.x ? boxMin.x : boxMax.x,
+                           contact.y < boxMin.y ? boxMin.y : boxMax.y);
+    return sweepCorner(center, radius, motion, corner);
+  }
+
+  glm::vec2 normal(0.0f);
+  if (x.Enter >= y.Enter)
+    normal.x = motion.x > 0.0f ? -1.0f : 1.0f;
+  else
+    normal.y = motion.y > 0.0f ? -1.0f : 1.0f;
+  return SweepHit {std::max(enter, 0.0f), normal};
+}
@@ -0,0 +1,34 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include <glm/glm.hpp>
+
+#include <optional>
+
+// First contact of a moving shape: the fraction of the motion after which
+// it touches the obstacle, and the obstacle's unit surface normal there
+struct SweepHit
+{
+  float Time;
+  glm::vec2 Normal;
+};
+
+// Sweeps a circle along motion against the axis-aligned box [boxMin, boxMax]
+// and returns the first contact within the motion. A circle that already
+// overlaps the box hits it at time 0 only while it moves further in, so it
+// can always leave a surface it was just resolved against.
+std::optional<SweepHit> SweepCircleAabb(glm::vec2 center,
+                                        float radius,
+                                        glm::vec2 motion,
+                                        glm::vec2 boxMin,
+                                        glm::vec2 boxMax);
+
+#endif
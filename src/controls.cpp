@@ -0,0 +1,79 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "controls.h"
+
+#include <cstddef>
+
+SimInput Controls::Apply(Simulation& sim, std::span<const KeyEvent> events)
+{
+  // apply the key changes in order, so a tap shorter than a tick still
+  // triggers its command
+  SimInput input;
+  for (const KeyEvent& event : events) {
+    if (event.Key < 0 || event.Key >= static_cast<int>(this->keys.size()))
+      continue;
+    const auto key = static_cast<std::size_t>(event.Key);
+    this->keys[key] = event.Pressed;
+    if (!event.Pressed)
+      this->keysProcessed[key] = false;
+    this->processCommands(sim);
+    input.Launch = input.Launch || this->keys[Key::Space];
+  }
+  // keys held through a state change act on the new state
+  this->processCommands(sim);
+  // paddle controls are applied by the simulation during the next step
+  input.MoveLeft = this->keys[Key::A];
+  input.MoveRight = this->keys[Key::D];
+  input.Launch = input.Launch || this->keys[Key::Space];
+  return input;
+}
+
+bool Controls::IsBound(int key)
+{
+  switch (key) {
+    case Key::Space:
+    case Key::A:
+    case Key::D:
+    case Key::H:
+    case Key::S:
+    case Key::W:
+    case Key::Enter:
+      return true;
+    default:
+      return false;
+  }
+}
+
+void Controls::processCommands(Simulation& sim)
+{
+  if (sim.State == GAME_MENU) {
+    if (this->keys[Key::Enter] && !this->keysProcessed[Key::Enter]) {
+      sim.Start();
+      this->keysProcessed[Key::Enter] = true;
+    }
+    if (this->keys[Key::W] && !this->keysProcessed[Key::W]) {
+      sim.SelectNextLevel();
+      this->keysProcessed[Key::W] = true;
+    }
+    if (this->keys[Key::S] && !this->keysProcessed[Key::S]) {
+      sim.SelectPreviousLevel();
+      this->keysProcessed[Key::S] = true;
+    }
+    if (this->keys[Key::H] && !this->keysProcessed[Key::H]) {
+      sim.ToggleHardMode();
+      this->keysProcessed[Key::H] = true;
+    }
+  }
+  if (sim.State == GAME_WIN) {
+    if (this->keys[Key::Enter]) {
+      this->keysProcessed[Key::Enter] = true;
+      sim.ReturnToMenu();
+    }
+  }
+}
@@ -0,0 +1,57 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef CONTROLS_H
+#define CONTROLS_H
+
+#include "simulation.h"
+
+#include <array>
+#include <span>
+
+// Keys the game reacts to. The codes are GLFW's, so key events from the
+// window are passed on unchanged.
+namespace Key
+{
+constexpr int Space = 32;
+constexpr int A = 65;
+constexpr int D = 68;
+constexpr int H = 72;
+constexpr int S = 83;
+constexpr int W = 87;
+constexpr int Enter = 257;
+}  // namespace Key
+
+// A key change as received from the window system
+struct KeyEvent
+{
+  int Key = 0;
+  bool Pressed = false;
+};
+
+// Controls turns key changes into menu commands and paddle input. It knows
+// nothing about windows, so the game and a headless replay of a recording
+// drive the simulation through the same code.
+class Controls
+{
+public:
+  // Applies the key changes of one tick in order, issuing menu commands to
+  // sim as they come, and returns the input for the tick's step
+  SimInput Apply(Simulation& sim, std::span<const KeyEvent> events);
+
+  // Whether a key has any effect; other keys can be dropped
+  static bool IsBound(int key);
+
+private:
+  void processCommands(Simulation& sim);
+
+  std::array<bool, 1024> keys {};
+  std::array<bool, 1024> keysProcessed {};
+};
+
+#endif
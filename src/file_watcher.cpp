@@ -0,0 +1,120 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "file_watcher.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+#if defined(__linux__)
+#  include <fcntl.h>
+#  include <sys/inotify.h>
+#  include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(Clock::duration debounceTime)
+    : debounce(debounceTime)
+{
+#if defined(__linux__)
+  this->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if defined(__linux__)
+  if (this->fd >= 0)
+    close(this->fd);
+#endif
+}
+
+bool FileWatcher::IsSupported()
+{
+#if defined(__linux__)
+  return true;
+#else
+  return false;
+#endif
+}
+
+bool FileWatcher::Watch(const std::filesystem::path& directory)
+{
+#if defined(__linux__)
+  if (this->fd < 0)
+    return false;
+  // editors either rewrite a file or replace it by renaming a new one
+  const int watch = inotify_add_watch(
+      this->fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+  if (watch < 0)
+    return false;
+  this->directories.emplace_back(watch, directory);
+  return true;
+#else
+  (void)directory;
+  return false;
+#endif
+}
+
+std::vector<std::filesystem::path> FileWatcher::Poll(Clock::time_point now)
+{
+  this->readEvents(now);
+  std::vector<std::filesystem::path> settled;
+  auto quiet = [this, now, &settled](Change& change)
+  {
+    if (now - change.Last < this->debounce)
+      return false;
+    settled.push_back(std::move(change.File));
+    return true;
+  };
+  this->changes.erase(
+      std::remove_if(this->changes.begin(), this->changes.end(), quiet),
+      this->changes.end());
+  return settled;
+}
+
+void FileWatcher::readEvents(Clock::time_point now)
+{
+#if defined(__linux__)
+  if (this->fd < 0)
+    return;
+  alignas(inotify_event) std::array<char, 4096> buffer;
+  for (;;) {
+    const ssize_t length = read(this->fd, buffer.data(), buffer.size());
+    // nothing (more) queued; the descriptor doesn't block
+    if (length <= 0)
+      return;
+    for (ssize_t offset = 0; offset < length;) {
+      inotify_event event;
+      std::memcpy(&event, buffer.data() + offset, sizeof(event));
+      const char* name = buffer.data() + offset + sizeof(event);
+      offset += static_cast<ssize_t>(sizeof(event) + event.len);
+      if (event.len == 0)
+        continue;
+      auto directory = std::find_if(this->directories.begin(),
+                                    this->directories.end(),
+                                    [&event](const auto& watched)
+                                    { return watched.first == event.wd; });
+      if (directory == this->directories.end())
+        continue;
+      // a file changed again restarts its wait
+      const std::filesystem::path file = directory->second / name;
+      auto change = std::find_if(this->changes.begin(),
+                                 this->changes.end(),
+                                 [&file](const Change& pending)
+                                 { return pending.File == file; });
+      if (change != this->changes.end())
+        change->Last = now;
+      else
+        this->changes.push_back(Change {file, now});
+    }
+  }
+#else
+  (void)now;
+#endif
+}
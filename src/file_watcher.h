@@ -0,0 +1,64 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef FILE_WATCHER_H
+#define FILE_WATCHER_H
+
+#include <chrono>
+#include <filesystem>
+#include <utility>
+#include <vector>
+
+// FileWatcher reports files that were written to or moved into watched
+// directories, using inotify on Linux; elsewhere it watches nothing. Editors
+// and build steps often touch a file several times in a row, so a file is
+// only reported once it has been left alone for the debounce time. Poll()
+// never blocks and costs one system call when nothing changed.
+class FileWatcher
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit FileWatcher(
+      Clock::duration debounceTime = std::chrono::milliseconds(100));
+  ~FileWatcher();
+
+  FileWatcher(const FileWatcher&) = delete;
+  FileWatcher& operator=(const FileWatcher&) = delete;
+
+  // Whether files can be watched on this platform
+  static bool IsSupported();
+
+  // Starts watching the files directly in directory; false if it can't be
+  // watched
+  bool Watch(const std::filesystem::path& directory);
+
+  // Returns the files that changed and then settled for the debounce time as
+  // of now, as the watched directory joined with the file name; each change
+  // is reported once
+  std::vector<std::filesystem::path> Poll(Clock::time_point now = Clock::now());
+
+private:
+  // A changed file waiting to settle
+  struct Change
+  {
+    std::filesystem::path File;
+    Clock::time_point Last;
+  };
+
+  // Moves the events the system has queued into changes
+  void readEvents(Clock::time_point now);
+
+  Clock::duration debounce;
+  int fd = -1;
+  // watch descriptors and the directories they watch
+  std::vector<std::pair<int, std::filesystem::path>> directories;
+  std::vector<Change> changes;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "frame_timing.h"
+
+#include <algorithm>
+#include <cmath>
+#include <ostream>
+
+FixedTimestep::FixedTimestep(double tickRate, unsigned int maxTicksPerFrame)
+    : tick(1.0 / tickRate)
+    , maxTicks(maxTicksPerFrame)
+{
+}
+
+unsigned int FixedTimestep::Advance(double frameSeconds)
+{
+  this->accumulator += std::max(frameSeconds, 0.0);
+  unsigned int count = 0;
+  while (this->accumulator >= this->tick && count < this->maxTicks) {
+    this->accumulator -= this->tick;
+    ++count;
+  }
+  // avoid the spiral of death: time the cap didn't let us simulate is
+  // dropped, only the fraction of a tick is kept
+  if (this->accumulator >= this->tick) {
+    const double behind = std::floor(this->accumulator / this->tick);
+    this->dropped += static_cast<unsigned long long>(behind);
+    this->accumulator -= behind * this->tick;
+  }
+  return count;
+}
+
+void FrameStats::AddFrame(double frameSeconds,
+                          double simSeconds,
+                          unsigned int tickCount)
+{
+  ++this->frames;
+  this->ticks += tickCount;
+  this->frameSum += frameSeconds;
+  this->frameSquares += frameSeconds * frameSeconds;
+  this->frameMax = std::max(this->frameMax, frameSeconds);
+  this->simSum += simSeconds;
+}
+
+void FrameStats::Reset()
+{
+  *this = FrameStats {};
+}
+
+double FrameStats::MeanFrameMs() const
+{
+  if (this->frames == 0)
+    return 0.0;
+  return this->frameSum / this->frames * 1000.0;
+}
+
+double FrameStats::FrameVarianceMs2() const
+{
+  if (this->frames == 0)
+    return 0.0;
+  const double mean = this->frameSum / this->frames;
+  const double variance = this->frameSquares / this->frames - mean * mean;
+  // rounding can make a constant frame time come out slightly negative
+  return std::max(variance, 0.0) * 1000.0 * 1000.0;
+}
+
+double FrameStats::SimLoad() const
+{
+  if (this->frameSum <= 0.0)
+    return 0.0;
+  return std::min(this->simSum / this->frameSum, 1.0);
+}
+
+void FrameStats::Report(std::ostream& out) const
+{
+  const double seconds = std::max(this->frameSum, 1e-9);
+  const auto tickCount = static_cast<double>(this->ticks);
+  out << "frames: " << this->frames / seconds << " fps, "
+      << this->MeanFrameMs() << " ms mean, "
+      << std::sqrt(this->FrameVarianceMs2()) << " ms stddev, "
+      << this->MaxFrameMs() << " ms max | sim: " << tickCount / seconds
+      << " ticks/s, " << this->SimLoad() * 100.0 << "% busy\n";
+}
@@ -0,0 +1,80 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef FRAME_TIMING_H
+#define FRAME_TIMING_H
+
+#include <iosfwd>
+
+// FixedTimestep turns variable frame times into a whole number of fixed
+// simulation ticks. Time that doesn't fill a tick is carried over to the next
+// frame; Alpha() tells how far the renderer is between the last two ticks.
+// At most maxTicksPerFrame ticks are run per frame; when the simulation
+// can't keep up, the excess time is dropped (the game slows down) instead of
+// piling up ever longer catch-up frames.
+class FixedTimestep
+{
+public:
+  explicit FixedTimestep(double tickRate = 120.0,
+                         unsigned int maxTicksPerFrame = 8);
+
+  // Adds the real time that passed since the last frame and returns the
+  // number of ticks to simulate now
+  unsigned int Advance(double frameSeconds);
+
+  // Length of one tick in seconds
+  float TickSeconds() const { return static_cast<float>(tick); }
+  double TickRate() const { return 1.0 / tick; }
+  // Fraction of a tick accumulated since the last tick, in [0, 1)
+  float Alpha() const { return static_cast<float>(accumulator / tick); }
+  // Ticks skipped because a frame needed more than maxTicksPerFrame
+  unsigned long long DroppedTicks() const { return dropped; }
+
+private:
+  double tick;
+  unsigned int maxTicks;
+  double accumulator = 0.0;
+  unsigned long long dropped = 0;
+};
+
+// FrameStats collects frame times, simulated ticks and the time spent
+// simulating over a reporting window, for tuning the tick rate of a
+// deployment
+class FrameStats
+{
+public:
+  // Records one frame: its total duration, the simulation time and ticks
+  // that completed during it
+  void AddFrame(double frameSeconds, double simSeconds, unsigned int tickCount);
+  // Starts a new window
+  void Reset();
+
+  unsigned int Frames() const { return frames; }
+  unsigned long long Ticks() const { return ticks; }
+  // Seconds covered by the recorded frames
+  double Elapsed() const { return frameSum; }
+  // Frame time statistics in milliseconds
+  double MeanFrameMs() const;
+  double FrameVarianceMs2() const;
+  double MaxFrameMs() const { return frameMax * 1000.0; }
+  // Share of the elapsed time spent simulating, in [0, 1]
+  double SimLoad() const;
+
+  // Prints a one-line summary of the window
+  void Report(std::ostream& out) const;
+
+private:
+  unsigned int frames = 0;
+  unsigned long long ticks = 0;
+  double frameSum = 0.0;
+  double frameSquares = 0.0;
+  double frameMax = 0.0;
+  double simSum = 0.0;
+};
+
+#endif
@@ -8,587 +8,450 @@
 ******************************************************************/
 #include "game.h"
 
-#include "game_object.h"
+#include "asset_loader.h"
 #include "resource_manager.h"
 
 #include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <exception>
 #include <iostream>
-#include <sstream>
+#include <string>
+#include <string_view>
 
-Game::Game(unsigned int width, unsigned int height)
+Game::Game(unsigned int width, unsigned int height, std::uint64_t seed)
     : Width(width)
     , Height(height)
+    , Sim(width, height, seed)
 {
+  // room for a full key queue, so ticks don't allocate
+  this->tickKeys.reserve(256);
 }
 
 void Game::Init()
 {
+  // files are read and decoded side by side on the loader's workers; what
+  // needs the GL context is done on this thread as they come in
+  AssetLoader loader;
   // load shaders
-  ResourceManager::LoadShader(
-      "shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
-  ResourceManager::LoadShader(
-      "shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
-  ResourceManager::LoadShader("shaders/post_processing.vert",
-                              "shaders/post_processing.frag",
-                              nullptr,
-                              "postprocessing");
-  // configure shaders
-  glm::mat4 projection = glm::ortho(0.0f,
-                                    static_cast<float>(this->Width),
-                                    static_cast<float>(this->Height),
-                                    0.0f,
-                                    -1.0f,
-                                    1.0f);
-  ResourceManager::GetShader("sprite").Use().SetInteger("image", 0);
-  ResourceManager::GetShader("sprite").SetMatrix4("projection", projection);
-  ResourceManager::GetShader("particle").Use().SetInteger("sprite", 0);
-  ResourceManager::GetShader("particle").SetMatrix4("projection", projection);
-  // Load textures
-  ResourceManager::LoadTexture("background.jpg", false);
-  // TODO: Rename texture to face.png.
-  ResourceManager::LoadTexture("awesomeface.png", true, "face");
-  ResourceManager::LoadTexture("block.png", false);
-  ResourceManager::LoadTexture("block_solid.png", false);
-  ResourceManager::LoadTexture("paddle.png", true);
-  ResourceManager::LoadTexture("particle.png", true);
-  ResourceManager::LoadTexture("powerup_speed.png", true);
-  ResourceManager::LoadTexture("powerup_sticky.png", true);
-  ResourceManager::LoadTexture("powerup_increase.png", true);
-  ResourceManager::LoadTexture("powerup_confuse.png", true);
-  ResourceManager::LoadTexture("powerup_chaos.png", true);
-  ResourceManager::LoadTexture("powerup_passthrough.png", true);
-  // set render-specific controls
-  Renderer = SpriteRenderer(ResourceManager::GetShader("sprite"));
-  Particles = ParticleGenerator(ResourceManager::GetShader("particle"),
-                                ResourceManager::GetTexture("particle"),
-                                500);
-  Effects = PostProcessor(
-      ResourceManager::GetShader("postprocessing"), this->Width, this->Height);
+  ResourceManager::LoadShaderAsync(
+      loader, "shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
+  ResourceManager::LoadShaderAsync(loader,
+                                   "shaders/particle.vert",
+                                   "shaders/particle.frag",
+                                   nullptr,
+                                   "particle");
+  ResourceManager::LoadShaderAsync(loader,
+                                   "shaders/post_processing.vert",
+                                   "shaders/post_processing.frag",
+                                   nullptr,
+                                   "postprocessing");
+  // Load textures; all sprites come from one atlas, so the sprite batch can
+  // draw them together whatever their image
+  ResourceManager::LoadTextureAtlasAsync(
+      loader,
+      {{"background.jpg"},
+       // TODO: Rename texture to face.png.
+       {"awesomeface.png", "face"},
+       {"block.png"},
+       {"block_solid.png"},
+       {"paddle.png"},
+       {"particle.png"},
+       {"powerup_speed.png"},
+       {"powerup_sticky.png"},
+       {"powerup_increase.png"},
+       {"powerup_confuse.png"},
+       {"powerup_chaos.png"},
+       {"powerup_passthrough.png"}},
+      "sprites");
   Text = TextRenderer(this->Width, this->Height);
-  Text.Load("fonts/OCRAEXT.TTF", 24);
-  // load levels
-  // TODO: Improve level loading
-  GameLevel one;
-  one.Load("levels/one.lvl", this->Width, this->Height / 2);
-  GameLevel two;
-  two.Load("levels/two.lvl", this->Width, this->Height / 2);
-  GameLevel three;
-  three.Load("levels/three.lvl", this->Width, this->Height / 2);
-  GameLevel four;
-  four.Load("levels/four.lvl", this->Width, this->Height / 2);
-  this->Levels.push_back(one);
-  this->Levels.push_back(two);
-  this->Levels.push_back(three);
-  this->Levels.push_back(four);
-  this->Level = 0;
-  // configure game objects
-  glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
-                                  this->Height - PLAYER_SIZE.y);
-  Player =
-      GameObject(playerPos, PLAYER_SIZE, ResourceManager::GetTexture("paddle"));
-
-  glm::vec2 ballPos = playerPos
-      + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
-  Ball = BallObject(ballPos,
-                    BALL_RADIUS,
-                    INITIAL_BALL_VELOCITY,
-                    ResourceManager::GetTexture("face"));
+  Text.LoadAsync(loader, "fonts/OCRAEXT.TTF", 24, GlyphMode::SDF);
   // audio
-  // load
-  soundEngine.loadSound("audio/bleep.mp3");
-  soundEngine.loadSound("audio/solid.wav");
-  soundEngine.loadSound("audio/powerup.wav");
-  soundEngine.loadSound("audio/bleep.wav");
+  for (const char* sound : {"audio/bleep.mp3",
+                            "audio/solid.wav",
+                            "audio/powerup.wav",
+                            "audio/bleep.wav"})
+    soundEngine.loadSoundAsync(loader, sound);
+  // load levels and configure game objects in the meantime
+  Sim.Init();
+  loader.WaitAll();
+  loader.Report(std::cout);
+
+  this->configureShaders();
+  // set render-specific controls
+  Sprites = SpriteBatch(ResourceManager::GetShader("sprite"_id));
+  Particles = ParticleGenerator(ResourceManager::GetShader("particle"_id),
+                                ResourceManager::GetTexture("particle"_id),
+                                50000,
+                                Sim.GetSeed());
+  Effects = PostProcessor(ResourceManager::GetShader("postprocessing"_id),
+                          this->Width,
+                          this->Height);
+  // give the renderer a state to draw before the first tick
+  this->publish(0.0f, 0.0);
   // play main theme
   soundEngine.playMusic("audio/breakout.mp3");
 }
 
-void Game::Update(float dt)
+void Game::WatchAssets()
 {
-  // update objects
-  Ball.Move(dt, this->Width);
-  // check for collisions
-  this->DoCollisions();
-  // update particles
-  Particles.Update(dt, Ball, 2, glm::vec2(Ball.Radius / 2.0f));
-  // update PowerUps
-  this->UpdatePowerUps(dt);
-  // reduce shake time
-  if (ShakeTime > 0.0f) {
-    ShakeTime -= dt;
-    if (ShakeTime <= 0.0f)
-      Effects.Shake = false;
-  }
-  // check loss condition
-  if (Ball.Position.y >= this->Height)  // did ball reach bottom edge?
-  {
-    --this->Lives;
-    // did the player lose all his lives? : game over
-    if (this->Lives == 0) {
-      this->ResetLevel();
-      this->State = GAME_MENU;
-    }
-    this->ResetPlayer();
-  }
-  // check win condition
-  if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsCompleted()) {
-    this->ResetLevel();
-    this->ResetPlayer();
-    Effects.Chaos = true;
-    this->State = GAME_WIN;
+  if (!FileWatcher::IsSupported()) {
+    std::cout << "WARNING::RELOAD: Files can't be watched on this platform"
+              << std::endl;
+    return;
   }
+  this->watcher = std::make_unique<FileWatcher>();
+  for (const char* directory : {"shaders", "textures", "levels"})
+    if (!this->watcher->Watch(directory))
+      std::cout << "WARNING::RELOAD: Could not watch " << directory
+                << std::endl;
+  // the files of one edit are few; one worker keeps them off this thread
+  this->reloader = std::make_unique<AssetLoader>(1);
 }
 
-/**
- * @brief Toggles hard mode.
- *
- * Modifies the acceleration factor that affects the ball velocity after each
- * bounce with the paddle.
- */
-void Game::ToggleHardMode()
+void Game::ReloadChangedAssets()
 {
-  m_options.hardModeOn = !m_options.hardModeOn;
-  m_options.accelerationFactor = m_options.hardModeOn
-      ? HardMode::accelerationFactor
-      : Classic::accelerationFactor;
-}
-
-void Game::ProcessInput(float dt)
-{
-  if (this->State == GAME_MENU) {
-    if (this->Keys[GLFW_KEY_ENTER] && !this->KeysProcessed[GLFW_KEY_ENTER]) {
-      this->State = GAME_ACTIVE;
-      this->KeysProcessed[GLFW_KEY_ENTER] = true;
-    }
-    if (this->Keys[GLFW_KEY_W] && !this->KeysProcessed[GLFW_KEY_W]) {
-      this->Level = (this->Level + 1) % 4;
-      this->KeysProcessed[GLFW_KEY_W] = true;
-    }
-    if (this->Keys[GLFW_KEY_S] && !this->KeysProcessed[GLFW_KEY_S]) {
-      if (this->Level > 0)
-        --this->Level;
-      else
-        this->Level = 3;
-      // this->Level = (this->Level - 1) % 4;
-      this->KeysProcessed[GLFW_KEY_S] = true;
-    }
-    if (this->Keys[GLFW_KEY_H] && !this->KeysProcessed[GLFW_KEY_H]) {
-      ToggleHardMode();
-      this->KeysProcessed[GLFW_KEY_H] = true;
-    }
-  }
-  if (this->State == GAME_WIN) {
-    if (this->Keys[GLFW_KEY_ENTER]) {
-      this->KeysProcessed[GLFW_KEY_ENTER] = true;
-      Effects.Chaos = false;
-      this->State = GAME_MENU;
+  if (!this->watcher)
+    return;
+  for (const std::filesystem::path& file : this->watcher->Poll()) {
+    // levels belong to the simulation thread, which loads them itself
+    if (file.parent_path() == "levels") {
+      if (!this->levelChanges.Push(file))
+        std::cout << "WARNING::RELOAD: Dropped change of " << file.string()
+                  << std::endl;
+      continue;
     }
+    for (AssetHandle& handle :
+         ResourceManager::ReloadAsync(*this->reloader, file))
+      this->reloads.push_back(std::move(handle));
   }
-  if (this->State == GAME_ACTIVE) {
-    float velocity = PLAYER_VELOCITY * dt;
-    // move playerboard
-    if (this->Keys[GLFW_KEY_A]) {
-      if (Player.Position.x >= 0.0f) {
-        Player.Position.x -= velocity;
-        if (Ball.Stuck)
-          Ball.Position.x -= velocity;
-      }
-    }
-    if (this->Keys[GLFW_KEY_D]) {
-      if (Player.Position.x <= this->Width - Player.Size.x) {
-        Player.Position.x += velocity;
-        if (Ball.Stuck)
-          Ball.Position.x += velocity;
-      }
+  if (this->reloads.empty() || this->reloader->Poll() == 0)
+    return;
+  bool reloaded = false;
+  auto finished = [&reloaded](const AssetHandle& handle)
+  {
+    if (!handle.Ready())
+      return false;
+    try {
+      handle.Wait();
+      reloaded = true;
+      std::cout << "reloaded " << handle.Name() << std::endl;
+    } catch (const std::exception& e) {
+      std::cout << "ERROR::RELOAD: " << e.what() << std::endl;
     }
-    if (this->Keys[GLFW_KEY_SPACE])
-      Ball.Stuck = false;
-  }
+    return true;
+  };
+  this->reloads.erase(
+      std::remove_if(this->reloads.begin(), this->reloads.end(), finished),
+      this->reloads.end());
+  if (reloaded)
+    this->useReloadedAssets();
 }
 
-void Game::Render()
+void Game::configureShaders()
 {
-  if (this->State == GAME_ACTIVE || this->State == GAME_MENU
-      || this->State == GAME_WIN)
-  {
-    // begin rendering to postprocessing framebuffer
-    Effects.BeginRender();
-    // draw background
-    Renderer.DrawSprite(ResourceManager::GetTexture("background"),
-                        glm::vec2(0.0f, 0.0f),
-                        glm::vec2(this->Width, this->Height),
-                        0.0f);
-    // draw level
-    this->Levels[this->Level].Draw(Renderer);
-    // draw player
-    Player.Draw(Renderer);
-    // draw PowerUps
-    for (PowerUp& powerUp : this->PowerUps)
-      if (!powerUp.Destroyed)
-        powerUp.Draw(Renderer);
-    // draw particles
-    Particles.Draw();
-    // draw ball
-    Ball.Draw(Renderer);
-    // end rendering to postprocessing framebuffer
-    Effects.EndRender();
-    // render postprocessing quad
-    Effects.Render(glfwGetTime());
-    // render text (don't include in postprocessing)
-    std::stringstream ss;
-    ss << this->Lives;
-    Text.RenderText("Lives:" + ss.str(), 5.0f, 5.0f, 1.0f);
-  }
-  if (this->State == GAME_MENU) {
-    Text.RenderText("Press ENTER to start", 250.0f, this->Height / 2.0f, 1.0f);
-    Text.RenderText("Press W or S to select level",
-                    245.0f,
-                    this->Height / 2.0f + 20.0f,
-                    0.75f);
-    std::string hardModeMessage = "Press H to toggle Hard Mode: ";
-    hardModeMessage += m_options.hardModeOn ? "ON" : "OFF";
-    Text.RenderText(
-        hardModeMessage, 225.0f, this->Height / 2.0f + 40.0f, 0.75f);
-  }
-  if (this->State == GAME_WIN) {
-    Text.RenderText("You WON!!!",
-                    320.0f,
-                    this->Height / 2.0f - 20.0f,
-                    1.0f,
-                    glm::vec3(0.0f, 1.0f, 0.0f));
-    Text.RenderText("Press ENTER to retry or ESC to quit",
-                    130.0f,
-                    this->Height / 2.0f,
-                    1.0f,
-                    glm::vec3(1.0f, 1.0f, 0.0f));
-  }
+  glm::mat4 projection = glm::ortho(0.0f,
+                                    static_cast<float>(this->Width),
+                                    static_cast<float>(this->Height),
+                                    0.0f,
+                                    -1.0f,
+                                    1.0f);
+  Shader& sprite = ResourceManager::GetShader("sprite"_id);
+  sprite.Use().SetInteger("image", 0);
+  sprite.SetMatrix4("projection", projection);
+  Shader& particle = ResourceManager::GetShader("particle"_id);
+  particle.Use().SetInteger("sprite", 0);
+  particle.SetMatrix4("projection", projection);
 }
 
-void Game::ResetLevel()
+void Game::useReloadedAssets()
 {
-  if (this->Level == 0)
-    this->Levels[0].Load("levels/one.lvl", this->Width, this->Height / 2);
-  else if (this->Level == 1)
-    this->Levels[1].Load("levels/two.lvl", this->Width, this->Height / 2);
-  else if (this->Level == 2)
-    this->Levels[2].Load("levels/three.lvl", this->Width, this->Height / 2);
-  else if (this->Level == 3)
-    this->Levels[3].Load("levels/four.lvl", this->Width, this->Height / 2);
-
-  this->Lives = 3;
+  // reloaded textures keep their texture objects, but images may have moved
+  // in the atlas; reloaded shaders are new programs
+  this->configureShaders();
+  Sprites.SetShader(ResourceManager::GetShader("sprite"_id));
+  Particles.SetShader(ResourceManager::GetShader("particle"_id));
+  Particles.SetTexture(ResourceManager::GetTexture("particle"_id));
+  Effects.SetShader(ResourceManager::GetShader("postprocessing"_id));
 }
 
-void Game::ResetPlayer()
+bool Game::PostKey(int key, bool pressed)
 {
-  // reset player/ball stats
-  Player.Size = PLAYER_SIZE;
-  Player.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
-                              this->Height - PLAYER_SIZE.y);
-  Ball.Reset(Player.Position
-                 + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
-                             -(BALL_RADIUS * 2.0f)),
-             INITIAL_BALL_VELOCITY);
-  // also disable all active powerups
-  Effects.Chaos = Effects.Confuse = false;
-  Ball.PassThrough = Ball.Sticky = false;
-  Player.Color = glm::vec3(1.0f);
-  Ball.Color = glm::vec3(1.0f);
-  // TODO: Rest all powerups floating down
+  return this->keyEvents.Push(KeyEvent {key, pressed});
 }
 
-// Powerups
-void Game::UpdatePowerUps(float dt)
+bool Game::Record(const std::filesystem::path& file, float tickSeconds)
 {
-  for (PowerUp& powerUp : this->PowerUps) {
-    powerUp.Position += powerUp.Velocity * dt;
-    if (powerUp.Activated) {
-      powerUp.Duration -= dt;
-
-      if (powerUp.Duration <= 0.0f) {
-        // remove powerup from list (will later be removed)
-        powerUp.Activated = false;
-        // deactivate effects
-        if (powerUp.Type == "sticky") {
-          if (!IsOtherPowerUpActive(this->PowerUps, "sticky"))
-          {  // only reset if no other PowerUp of type sticky is active
-            Ball.Sticky = false;
-            Player.Color = glm::vec3(1.0f);
-          }
-        } else if (powerUp.Type == "pass-through") {
-          if (!IsOtherPowerUpActive(this->PowerUps, "pass-through"))
-          {  // only reset if no other PowerUp of type pass-through is active
-            Ball.PassThrough = false;
-            Ball.Color = glm::vec3(1.0f);
-          }
-        } else if (powerUp.Type == "confuse") {
-          if (!IsOtherPowerUpActive(this->PowerUps, "confuse"))
-          {  // only reset if no other PowerUp of type confuse is active
-            Effects.Confuse = false;
-          }
-        } else if (powerUp.Type == "chaos") {
-          if (!IsOtherPowerUpActive(this->PowerUps, "chaos"))
-          {  // only reset if no other PowerUp of type chaos is active
-            Effects.Chaos = false;
-          }
-        }
-      }
-    }
+  this->recorder = std::make_unique<ReplayRecorder>(file, Sim, tickSeconds);
+  if (!this->recorder->IsOpen()) {
+    std::cout << "ERROR::GAME: Could not record to " << file.string()
+              << std::endl;
+    this->recorder.reset();
+    return false;
   }
-  // Remove all PowerUps from vector that are destroyed AND !activated (thus
-  // either off the map or finished) Note we use a lambda expression to remove
-  // each PowerUp which is destroyed and not activated
-  this->PowerUps.erase(
-      std::remove_if(this->PowerUps.begin(),
-                     this->PowerUps.end(),
-                     [](const PowerUp& powerUp)
-                     { return powerUp.Destroyed && !powerUp.Activated; }),
-      this->PowerUps.end());
+  return true;
 }
 
-bool Game::ShouldSpawn(unsigned int chance)
+bool Game::StopRecording()
 {
-  // TODO: Use different random number generator
-  unsigned int random = rand() % chance;
-  return random == 0;
+  if (!this->recorder)
+    return false;
+  const bool written = this->recorder->Finish(Sim);
+  if (written)
+    std::cout << "recorded " << this->recorder->Ticks() << " ticks"
+              << std::endl;
+  else
+    std::cout << "ERROR::GAME: Could not write the recording" << std::endl;
+  this->recorder.reset();
+  return written;
 }
 
-void Game::SpawnPowerUps(GameObject& block)
+void Game::Update(float dt)
 {
-  if (ShouldSpawn(75))  // 1 in 75 chance
-    this->PowerUps.push_back(
-        PowerUp("speed",
-                glm::vec3(0.5f, 0.5f, 1.0f),
-                0.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_speed")));
-  if (ShouldSpawn(75))
-    this->PowerUps.push_back(
-        PowerUp("sticky",
-                glm::vec3(1.0f, 0.5f, 1.0f),
-                20.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_sticky")));
-  if (ShouldSpawn(75))
-    this->PowerUps.push_back(
-        PowerUp("pass-through",
-                glm::vec3(0.5f, 1.0f, 0.5f),
-                10.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_passthrough")));
-  if (ShouldSpawn(75))
-    this->PowerUps.push_back(
-        PowerUp("pad-size-increase",
-                glm::vec3(1.0f, 0.6f, 0.4),
-                0.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_increase")));
-  if (ShouldSpawn(15))  // Negative powerups should spawn more often
-    this->PowerUps.push_back(
-        PowerUp("confuse",
-                glm::vec3(1.0f, 0.3f, 0.3f),
-                15.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_confuse")));
-  if (ShouldSpawn(15))
-    this->PowerUps.push_back(
-        PowerUp("chaos",
-                glm::vec3(0.9f, 0.25f, 0.25f),
-                15.0f,
-                block.Position,
-                ResourceManager::GetTexture("powerup_chaos")));
+  const double start = glfwGetTime();
+  this->processInput();
+  // levels edited on disk replace the loaded ones
+  std::filesystem::path level;
+  while (this->levelChanges.Pop(level)) {
+    if (Sim.ReloadLevel(level)) {
+      ++this->levelStamp;
+      std::cout << "reloaded " << level.string() << std::endl;
+    }
+  }
+  // remember where things were to interpolate from
+  this->previousBall = Sim.Ball.Position;
+  this->previousPlayer = Sim.Player.Position;
+  this->previousSerials.fill(0);
+  Sim.PowerUps.ForEach(
+      [this](std::size_t slot, const PowerUp& powerUp)
+      {
+        this->previousPowerUps[slot] = powerUp.Position;
+        this->previousSerials[slot] = Sim.PowerUps.Serial(slot);
+      });
+  // advance the simulation
+  Sim.Step(dt, Input);
+  ++this->ticks;
+  this->handleEvents();
+  this->publish(dt, glfwGetTime() - start);
 }
 
-void Game::ActivatePowerUp(PowerUp& powerUp)
+void Game::handleEvents()
 {
-  if (powerUp.Type == "speed") {
-    Ball.Velocity *= 1.2;
-  } else if (powerUp.Type == "sticky") {
-    Ball.Sticky = true;
-    Player.Color = glm::vec3(1.0f, 0.5f, 1.0f);
-  } else if (powerUp.Type == "pass-through") {
-    Ball.PassThrough = true;
-    Ball.Color = glm::vec3(1.0f, 0.5f, 0.5f);
-  } else if (powerUp.Type == "pad-size-increase") {
-    Player.Size.x += 50;
-  } else if (powerUp.Type == "confuse") {
-    if (!Effects.Chaos)
-      Effects.Confuse = true;  // only activate if chaos wasn't already active
-  } else if (powerUp.Type == "chaos") {
-    if (!Effects.Confuse)
-      Effects.Chaos = true;
+  for (const SimEvent& event : Sim.Events()) {
+    switch (event.Type) {
+      case SimEventType::BrickDestroyed:
+        soundEngine.play2D("audio/bleep.mp3", false);
+        break;
+      case SimEventType::SolidBrickHit:
+        soundEngine.play2D("audio/solid.wav", false);
+        break;
+      case SimEventType::PaddleHit:
+        soundEngine.play2D("audio/bleep.wav", false);
+        break;
+      case SimEventType::PowerUpActivated:
+        soundEngine.play2D("audio/powerup.wav", false);
+        break;
+      case SimEventType::LifeLost:
+      case SimEventType::LevelCompleted:
+        // the ball was reset; don't render it flying back to the paddle
+        this->previousBall = Sim.Ball.Position;
+        this->previousPlayer = Sim.Player.Position;
+        break;
+    }
   }
 }
 
-bool Game::IsOtherPowerUpActive(std::vector<PowerUp>& powerUps,
-                                std::string type)
+void Game::processInput()
 {
-  // Check if another PowerUp of the same type is still active
-  // in which case we don't disable its effect (yet)
-  for (const PowerUp& powerUp : powerUps) {
-    if (powerUp.Activated)
-      if (powerUp.Type == type)
-        return true;
-  }
-  return false;
+  this->tickKeys.clear();
+  KeyEvent event;
+  while (this->keyEvents.Pop(event))
+    this->tickKeys.push_back(event);
+  if (this->recorder)
+    this->recorder->RecordTick(this->tickKeys);
+  Input = this->controls.Apply(Sim, this->tickKeys);
 }
 
-// Collision detection
-// TODO: Use type instead of index for std::get
-void Game::DoCollisions()
+void Game::publish(float dt, double busySeconds)
 {
-  for (GameObject& box : this->Levels[this->Level].Bricks) {
-    if (!box.Destroyed) {
-      Collision collision = CheckCollision(Ball, box);
-      if (std::get<0>(collision))  // if collision is true
-      {
-        // destroy block if not solid
-        if (!box.IsSolid) {
-          box.Destroyed = true;
-          this->SpawnPowerUps(box);
-          soundEngine.play2D("audio/bleep.mp3", false);
-        } else {  // if block is solid, enable shake effect
-          ShakeTime = 0.05f;
-          Effects.Shake = true;
-          soundEngine.play2D("audio/solid.wav", false);
-        }
-        // collision resolution
-        Direction dir = std::get<1>(collision);
-        glm::vec2 diff_vector = std::get<2>(collision);
-        if (!(Ball.PassThrough
-              && !box.IsSolid))  // don't do collision resolution on non-solid
-                                 // bricks if pass-through is activated
-        {
-          if (dir == LEFT || dir == RIGHT)  // horizontal collision
-          {
-            Ball.Velocity.x = -Ball.Velocity.x;  // reverse horizontal velocity
-            // relocate
-            float penetration = Ball.Radius - std::abs(diff_vector.x);
-            if (dir == LEFT)
-              Ball.Position.x += penetration;  // move ball to right
-            else
-              Ball.Position.x -= penetration;  // move ball to left;
-          } else  // vertical collision
-          {
-            Ball.Velocity.y = -Ball.Velocity.y;  // reverse vertical velocity
-            // relocate
-            float penetration = Ball.Radius - std::abs(diff_vector.y);
-            if (dir == UP)
-              Ball.Position.y -= penetration;  // move ball back up
-            else
-              Ball.Position.y += penetration;  // move ball back down
-          }
-        }
-      }
-    }
+  this->simSeconds += busySeconds;
+  // the slot is reused, so copying into its vectors doesn't allocate once
+  // they have grown to the level's size
+  RenderSnapshot& snapshot = this->snapshots.Back();
+  snapshot.State = Sim.State;
+  snapshot.Lives = Sim.Lives;
+  snapshot.HardMode = Sim.IsHardModeOn();
+  snapshot.Effects = Sim.Effects;
+  // the bricks don't change while a level is played, only which of them
+  // are destroyed
+  const GameLevel& level = Sim.Levels[Sim.Level];
+  if (Sim.Level != this->publishedLevel) {
+    this->publishedLevel = Sim.Level;
+    ++this->levelStamp;
   }
-
-  // also check collisions on PowerUps and if so, activate them
-  for (PowerUp& powerUp : this->PowerUps) {
-    if (!powerUp.Destroyed) {
-      // first check if powerup passed bottom edge, if so: keep as inactive and
-      // destroy
-      if (powerUp.Position.y >= this->Height)
-        powerUp.Destroyed = true;
-
-      if (CheckCollision(Player, powerUp))
-      {  // collided with player, now activate powerup
-        ActivatePowerUp(powerUp);
-        powerUp.Destroyed = true;
-        powerUp.Activated = true;
-        soundEngine.play2D("audio/powerup.wav", false);
-      }
-    }
-  }
-
-  // and finally check collisions for player pad (unless stuck)
-  Collision result = CheckCollision(Ball, Player);
-  if (!Ball.Stuck && std::get<0>(result)) {
-    // check where it hit the board, and change velocity based on where it hit
-    // the board
-    float centerBoard = Player.Position.x + Player.Size.x / 2.0f;
-    float distance = (Ball.Position.x + Ball.Radius) - centerBoard;
-    float percentage = distance / (Player.Size.x / 2.0f);
-    // then move accordingly
-    float strength = 2.0f;
-    glm::vec2 oldVelocity = Ball.Velocity;
-    Ball.Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
-    // Ball.Velocity.y = -Ball.Velocity.y;
-    Ball.Velocity = glm::normalize(Ball.Velocity)
-        * glm::length(oldVelocity);  // keep speed consistent over both axes
-                                     // (multiply by length of old velocity, so
-                                     // total strength is not changed)
-    // fix sticky paddle
-    Ball.Velocity.y = -1.0f * abs(Ball.Velocity.y);
-
-    Ball.Velocity *= m_options.accelerationFactor;
-
-    // if Sticky powerup is activated, also stick ball to paddle once new
-    // velocity vectors were calculated
-    Ball.Stuck = Ball.Sticky;
-
-    soundEngine.play2D("audio/bleep.wav", false);
+  if (snapshot.LevelStamp != this->levelStamp) {
+    snapshot.Bricks = level.Bricks;
+    snapshot.LevelStamp = this->levelStamp;
   }
+  snapshot.AliveBricks = level.AliveBricks();
+  // power-ups spawned during the tick aren't interpolated
+  snapshot.PowerUps.clear();
+  Sim.PowerUps.ForEach(
+      [this, &snapshot](std::size_t slot, const PowerUp& powerUp)
+      {
+        const bool moved =
+            this->previousSerials[slot] == Sim.PowerUps.Serial(slot);
+        snapshot.PowerUps.push_back(PowerUpSprite {
+            powerUp,
+            moved ? this->previousPowerUps[slot] : powerUp.Position,
+            GetPowerUpInfo(powerUp.Type).Texture});
+      });
+  snapshot.Player = Sim.Player;
+  snapshot.Ball = Sim.Ball;
+  snapshot.PreviousPlayer = this->ticks > 0 ? this->previousPlayer
+                                            : Sim.Player.Position;
+  snapshot.PreviousBall =
+      this->ticks > 0 ? this->previousBall : Sim.Ball.Position;
+  snapshot.Time = glfwGetTime();
+  snapshot.TickSeconds = dt;
+  snapshot.Tick = this->ticks;
+  snapshot.SimSeconds = this->simSeconds;
+  this->snapshots.Publish();
 }
 
-bool Game::CheckCollision(GameObject& one,
-                          GameObject& two)  // AABB - AABB collision
+unsigned long long Game::TicksSimulated() const
 {
-  // collision x-axis?
-  bool collisionX = one.Position.x + one.Size.x >= two.Position.x
-      && two.Position.x + two.Size.x >= one.Position.x;
-  // collision y-axis?
-  bool collisionY = one.Position.y + one.Size.y >= two.Position.y
-      && two.Position.y + two.Size.y >= one.Position.y;
-  // collision only if on both axes
-  return collisionX && collisionY;
+  return this->snapshots.Front().Tick;
 }
 
-Collision Game::CheckCollision(BallObject& one,
-                               GameObject& two)  // AABB - Circle collision
+unsigned int Game::TextureBinds() const
 {
-  // get center point circle first
-  glm::vec2 center(one.Position + one.Radius);
-  // calculate AABB info (center, half-extents)
-  glm::vec2 aabb_half_extents(two.Size.x / 2.0f, two.Size.y / 2.0f);
-  glm::vec2 aabb_center(two.Position.x + aabb_half_extents.x,
-                        two.Position.y + aabb_half_extents.y);
-  // get difference vector between both centers
-  glm::vec2 difference = center - aabb_center;
-  glm::vec2 clamped =
-      glm::clamp(difference, -aabb_half_extents, aabb_half_extents);
-  // now that we know the clamped values, add this to AABB_center and we get the
-  // value of box closest to circle
-  glm::vec2 closest = aabb_center + clamped;
-  // now retrieve vector between center circle and closest point AABB and check
-  // if length < radius
-  difference = closest - center;
+  return this->textureBinds;
+}
 
-  if (glm::length(difference)
-      < one.Radius)  // not <= since in that case a collision also occurs when
-                     // object one exactly touches object two, which they are at
-                     // the end of each collision resolution stage.
-    return std::make_tuple(true, VectorDirection(difference), difference);
-  else
-    return std::make_tuple(false, UP, glm::vec2(0.0f, 0.0f));
+double Game::SecondsSimulating() const
+{
+  return this->snapshots.Front().SimSeconds;
 }
 
-// calculates which direction a vector is facing (N,E,S or W)
-Direction Game::VectorDirection(glm::vec2 target)
+void Game::Render(double time)
 {
-  glm::vec2 compass[] = {
-      glm::vec2(0.0f, 1.0f),  // up
-      glm::vec2(1.0f, 0.0f),  // right
-      glm::vec2(0.0f, -1.0f),  // down
-      glm::vec2(-1.0f, 0.0f)  // left
-  };
-  float max = 0.0f;
-  unsigned int best_match = -1;
-  for (unsigned int i = 0; i < 4; i++) {
-    float dot_product = glm::dot(glm::normalize(target), compass[i]);
-    if (dot_product > max) {
-      max = dot_product;
-      best_match = i;
-    }
+  this->snapshots.Fetch();
+  const RenderSnapshot& frame = this->snapshots.Front();
+
+  // particles follow the ball once per tick, however many frames that takes;
+  // after a stall only the last few ticks are caught up on
+  const unsigned long long maxParticleTicks = 8;
+  if (frame.Tick - this->particleTick > maxParticleTicks)
+    this->particleTick = frame.Tick - maxParticleTicks;
+  for (; this->particleTick < frame.Tick; ++this->particleTick)
+    Particles.Update(
+        frame.TickSeconds, frame.Ball, 2, glm::vec2(frame.Ball.Radius / 2.0f));
+
+  // moving objects are drawn between their last two simulated positions,
+  // one tick behind the simulation
+  float alpha = 1.0f;
+  if (frame.TickSeconds > 0.0f)
+    alpha = glm::clamp(
+        static_cast<float>((time - frame.Time) / double {frame.TickSeconds}),
+        0.0f,
+        1.0f);
+  auto interpolate = [alpha](glm::vec2 from, glm::vec2 to)
+  { return glm::mix(from, to, alpha); };
+
+  if (frame.State == GAME_ACTIVE || frame.State == GAME_MENU
+      || frame.State == GAME_WIN)
+  {
+    // mirror the simulation's screen effects
+    Effects.Confuse = frame.Effects.Confuse;
+    Effects.Chaos = frame.Effects.Chaos;
+    Effects.Shake = frame.Effects.Shake;
+    // begin rendering to postprocessing framebuffer
+    Effects.BeginRender();
+    Sprites.Begin();
+    // draw background
+    Sprites.Draw(ResourceManager::GetTexture("background"_id),
+                 glm::vec2(0.0f, 0.0f),
+                 glm::vec2(this->Width, this->Height),
+                 0.0f);
+    // draw level; the atlas keeps all sprites in one batch, drawn in order
+    const TextureRegion block = ResourceManager::GetTexture("block"_id);
+    const TextureRegion blockSolid =
+        ResourceManager::GetTexture("block_solid"_id);
+    const BrickLayout& bricks = frame.Bricks;
+    for (std::size_t i = 0; i < bricks.Count(); ++i)
+      if (frame.AliveBricks.Test(i))
+        Sprites.Draw(bricks.IsSolid(i) ? blockSolid : block,
+                     bricks.Positions[i],
+                     bricks.Size,
+                     0.0f,
+                     bricks.Color(i));
+    // draw player
+    const GameObject& player = frame.Player;
+    Sprites.Draw(ResourceManager::GetTexture("paddle"_id),
+                 interpolate(frame.PreviousPlayer, player.Position),
+                 player.Size,
+                 player.Rotation,
+                 player.Color);
+    // draw PowerUps
+    for (const PowerUpSprite& powerUp : frame.PowerUps)
+      if (!powerUp.Body.Destroyed)
+        Sprites.Draw(ResourceManager::GetTexture(powerUp.Texture),
+                     interpolate(powerUp.Previous, powerUp.Body.Position),
+                     powerUp.Body.Size,
+                     powerUp.Body.Rotation,
+                     powerUp.Body.Color);
+    Sprites.Flush();
+    // draw particles
+    Particles.Draw();
+    // draw ball
+    const BallObject& ball = frame.Ball;
+    Sprites.Draw(ResourceManager::GetTexture("face"_id),
+                 interpolate(frame.PreviousBall, ball.Position),
+                 ball.Size,
+                 ball.Rotation,
+                 ball.Color);
+    Sprites.End();
+    // end rendering to postprocessing framebuffer
+    Effects.EndRender();
+    // render postprocessing quad
+    Effects.Render(static_cast<float>(time));
+    // render text (don't include in postprocessing); formatted on the stack,
+    // the text renderer only lays it out again when the number changes
+    std::array<char, 32> lives {"Lives:"};
+    const char* livesEnd = std::to_chars(lives.data() + 6,
+                                         lives.data() + lives.size(),
+                                         frame.Lives)
+                               .ptr;
+    Text.RenderText(std::string_view(lives.data(), livesEnd), 5.0f, 5.0f, 1.0f);
+  }
+  if (frame.State == GAME_MENU) {
+    Text.RenderText("Press ENTER to start", 250.0f, this->Height / 2.0f, 1.0f);
+    Text.RenderText("Press W or S to select level",
+                    245.0f,
+                    this->Height / 2.0f + 20.0f,
+                    0.75f);
+    Text.RenderText(frame.HardMode ? "Press H to toggle Hard Mode: ON"
+                                   : "Press H to toggle Hard Mode: OFF",
+                    225.0f,
+                    this->Height / 2.0f + 40.0f,
+                    0.75f);
+  }
+  if (frame.State == GAME_WIN) {
+    Text.RenderText("You WON!!!",
+                    320.0f,
+                    this->Height / 2.0f - 20.0f,
+                    1.0f,
+                    glm::vec3(0.0f, 1.0f, 0.0f));
+    Text.RenderText("Press ENTER to retry or ESC to quit",
+                    130.0f,
+                    this->Height / 2.0f,
+                    1.0f,
+                    glm::vec3(1.0f, 1.0f, 0.0f));
   }
-  return (Direction)best_match;
+  // all text of the frame goes out in one draw call
+  Text.Flush();
+  this->textureBinds = Sprites.GetStats().TextureBinds
+      + Particles.GetStats().DrawCalls + Text.GetStats().DrawCalls;
 }
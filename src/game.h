@@ -9,136 +9,175 @@
 #ifndef GAME_H
 #define GAME_H
 
-#include "ball_object.h"
-#include "game_level.h"
+#include "asset_loader.h"
+#include "bit_set.h"
+#include "controls.h"
+#include "file_watcher.h"
 #include "particle_generator.h"
 #include "post_processor.h"
-#include "power_up.h"
+#include "replay.h"
+#include "resource_registry.h"
+#include "simulation.h"
 #include "sound_engine.h"
-#include "sprite_renderer.h"
+#include "spsc_queue.h"
+#include "sprite_batch.h"
 #include "text_renderer.h"
+#include "triple_buffer.h"
 
 // clang-format off
 #include <glad/glad.h>  // GLAD must be included before GLFW
 #include <GLFW/glfw3.h>
 // clang-format on
 
-#include <tuple>
-#include <vector>
-
-// TODO: Use enum class
-// Represents the current state of the game
-enum GameState
-{
-  GAME_ACTIVE,
-  GAME_MENU,
-  GAME_WIN
-};
-
-// Represents the four possible (collision) directions
-enum Direction
-{
-  UP,
-  RIGHT,
-  DOWN,
-  LEFT
-};
+#include <glm/glm.hpp>
 
-namespace Classic
-{
-constexpr float accelerationFactor = 1.0f;
-}
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <vector>
 
-namespace HardMode
-{
-constexpr float accelerationFactor = 1.05f;
-}
-
-// Defines a Collision typedef that represents collision data
-typedef std::tuple<bool, Direction, glm::vec2>
-    Collision;  // <collision?, what direction?, difference vector center -
-                // closest point>
-
-// TODO: Change to lowercase
-// TODO: Use constexpr/constinit
-// Initial size of the player paddle
-const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
-// Initial velocity of the player paddle
-const float PLAYER_VELOCITY(500.0f);
-// Initial velocity of the Ball
-const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
-// Radius of the ball object
-const float BALL_RADIUS = 12.5f;
-
-// Game holds all game-related state and functionality.
-// Combines all game-related data into a single class for
-// easy access to each of the components and manageability.
+// Game is the interactive client of the Simulation. It translates keyboard
+// input into simulation commands and presents the simulation state: sprites,
+// particles, post-processing effects, text and sound.
+//
+// The simulation and the renderer run on separate threads. Keys travel to the
+// simulation thread through a queue; after every tick the simulation thread
+// publishes a snapshot of everything Render() draws, and the render thread
+// draws the newest one. No other state is shared between them.
 class Game
 {
 public:
-  // constructor/destructor
-  Game(unsigned int width, unsigned int height);
+  // constructor/destructor; the seed is the simulation's (see Simulation)
+  // and also drives the particle effects
+  Game(unsigned int width, unsigned int height, std::uint64_t seed = 0);
 
-  // initialize game state (load all shaders/textures/levels)
+  // initialize game state (load all shaders/textures/levels); call before
+  // starting the simulation thread
   void Init();
-  // game loop
-  void ProcessInput(float dt);
+
+  // Any one thread (the one receiving window events): queues a key press or
+  // release for the next tick; false if the queue is full and it was dropped
+  bool PostKey(int key, bool pressed);
+
+  // Simulation thread: applies the queued keys, advances the simulation by one
+  // fixed tick and publishes the result
   void Update(float dt);
-  void Render();
 
-  // Public data
-  // TODO: Convert to std::array
-  // TODO: Make private. These need to be public for the key_callback function.
-  bool Keys[1024] {};
-  bool KeysProcessed[1024] {};
+  // Records the keys of the game to a replay file from the first tick on;
+  // call after Init() and before starting the simulation thread. False if
+  // the file couldn't be created.
+  bool Record(const std::filesystem::path& file, float tickSeconds);
+  // Ends the recording with the state after the last tick; call once the
+  // simulation thread stopped. False if the file couldn't be written.
+  bool StopRecording();
+
+  // Render thread: draws the newest snapshot, interpolated between its tick
+  // and the one before for the given time (seconds on the clock passed to
+  // Update's caller, glfwGetTime())
+  void Render(double time);
+  // Render thread: watches the shader, texture and level directories, so
+  // files edited while the game runs are loaded again; call after Init()
+  void WatchAssets();
+  // Render thread: starts loading the files that changed and swaps in the
+  // ones that finished loading, without blocking
+  void ReloadChangedAssets();
+  // Render thread: simulation progress as of the snapshot drawn last
+  unsigned long long TicksSimulated() const;
+  double SecondsSimulating() const;
+  // Render thread: textures bound for sprites, particles and text in the last
+  // frame
+  unsigned int TextureBinds() const;
 
 private:
-  // Collisions
-  void DoCollisions();
-  bool CheckCollision(GameObject& one, GameObject& two);
-  Collision CheckCollision(BallObject& one, GameObject& two);
-  Direction VectorDirection(glm::vec2 closest);
-
-  // Reset
-  void ResetLevel();
-  void ResetPlayer();
-
-  // Power ups
-  void UpdatePowerUps(float dt);
-  bool ShouldSpawn(unsigned int chance);
-  void SpawnPowerUps(GameObject& block);
-  void ActivatePowerUp(PowerUp& powerUp);
-  bool IsOtherPowerUpActive(std::vector<PowerUp>& powerUps, std::string type);
-
-  // Hard mode
-  void ToggleHardMode();
+  // A power-up as drawn, with its position in the previous tick
+  struct PowerUpSprite
+  {
+    GameObject Body {};
+    glm::vec2 Previous {0.0f};
+    ResourceId Texture {};
+  };
+
+  // Everything Render() needs from one tick. Produced by the simulation thread
+  // and never changed once published.
+  struct RenderSnapshot
+  {
+    GameState State = GAME_MENU;
+    unsigned int Lives = 0;
+    bool HardMode = false;
+    SimEffects Effects {};
+    // the level's bricks, only copied again when LevelStamp changes, and
+    // which of them are still standing
+    BrickLayout Bricks {};
+    BitSet AliveBricks {};
+    unsigned long long LevelStamp = 0;
+    std::vector<PowerUpSprite> PowerUps;
+    GameObject Player {};
+    BallObject Ball {};
+    glm::vec2 PreviousPlayer {0.0f};
+    glm::vec2 PreviousBall {0.0f};
+    // when the tick was published, its length and the running totals of
+    // ticks and time spent in Update()
+    double Time = 0.0;
+    float TickSeconds = 0.0f;
+    unsigned long long Tick = 0;
+    double SimSeconds = 0.0;
+  };
+
+  // Simulation thread
+  // Applies the keys queued since the last tick
+  void processInput();
+  // Plays sounds for the events of the last simulation step
+  void handleEvents();
+  void publish(float dt, double busySeconds);
+
+  // Render thread
+  // Sets the projection and samplers of the sprite and particle shaders
+  void configureShaders();
+  // Hands reloaded shaders and textures to the renderers
+  void useReloadedAssets();
 
   // Data
-  GameState State = GAME_MENU;
   unsigned int Width;
   unsigned int Height;
-  std::vector<GameLevel> Levels;
-  std::vector<PowerUp> PowerUps;
-  unsigned int Level = 0;
-  unsigned int Lives = 3;
-
-  // Game-related state data
-  SpriteRenderer Renderer {};
-  GameObject Player {};
-  BallObject Ball {};
-  ParticleGenerator Particles {};
-  PostProcessor Effects {};
+
+  // Simulation thread state
+  Simulation Sim;
+  SimInput Input {};
+  Controls controls {};
+  // the key changes applied in the current tick
+  std::vector<KeyEvent> tickKeys;
+  std::unique_ptr<ReplayRecorder> recorder;
+  // positions before the current tick, for interpolation
+  glm::vec2 previousBall {0.0f};
+  glm::vec2 previousPlayer {0.0f};
+  // power-ups by slot, with the serial of the one that was in the slot
+  std::array<glm::vec2, PowerUpPool::Capacity> previousPowerUps {};
+  std::array<std::uint32_t, PowerUpPool::Capacity> previousSerials {};
+  // changes whenever another level is played or the level was reloaded
+  unsigned long long levelStamp = 1;
+  unsigned int publishedLevel = 0;
+  unsigned long long ticks = 0;
+  double simSeconds = 0.0;
   SoundEngine soundEngine {};
-  TextRenderer Text {};
 
-  float ShakeTime = 0.0f;
+  // Handoff between the threads
+  SpscQueue<KeyEvent, 256> keyEvents {};
+  TripleBuffer<RenderSnapshot> snapshots {};
+  // level files that changed on disk
+  SpscQueue<std::filesystem::path, 16> levelChanges {};
 
-  struct Options
-  {
-    bool hardModeOn = false;
-    float accelerationFactor = Classic::accelerationFactor;
-  };
-  Options m_options {};
+  // Render thread state
+  unsigned long long particleTick = 0;
+  unsigned int textureBinds = 0;
+  SpriteBatch Sprites {};
+  ParticleGenerator Particles {};
+  PostProcessor Effects {};
+  TextRenderer Text {};
+  // hot reloading, when enabled
+  std::unique_ptr<FileWatcher> watcher;
+  std::unique_ptr<AssetLoader> reloader;
+  std::vector<AssetHandle> reloads;
 };
 
 #endif
@@ -8,100 +8,181 @@
 ******************************************************************/
 #include "game_level.h"
 
-#include <fstream>
-#include <sstream>
+#include "level_file.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <optional>
+#include <string_view>
+
+namespace
+{
+// brick colors by palette index: 0 for codes without a color of their own,
+// the others by tile code
+const std::array<glm::vec3, 6> brickColors {
+    glm::vec3(1.0f),  // white
+    glm::vec3(0.8f, 0.8f, 0.7f),  // solid
+    glm::vec3(0.2f, 0.6f, 1.0f),
+    glm::vec3(0.0f, 0.7f, 0.0f),
+    glm::vec3(0.8f, 0.8f, 0.4f),
+    glm::vec3(1.0f, 0.5f, 0.0f)};
+}  // namespace
+
+glm::vec3 BrickLayout::Color(std::size_t brick) const
+{
+  return brickColors[this->Colors[brick]];
+}
 
 // TODO: Use string_view, string, or other alternative for file name
 void GameLevel::Load(const char* file,
                      unsigned int levelWidth,
                      unsigned int levelHeight)
 {
-  // clear old data
-  this->Bricks.clear();
-  // load from file
-  unsigned int tileCode;
-  GameLevel level;
-  std::string line;
-  std::ifstream fstream(file);
-  // TODO: Replace vector of vector
-  std::vector<std::vector<unsigned int>> tileData;
-  if (fstream) {
-    while (std::getline(fstream, line))  // read each line from level file
-    {
-      std::istringstream sstream(line);
-      std::vector<unsigned int> row;
-      while (sstream >> tileCode)  // read each word separated by spaces
-        row.push_back(tileCode);
-      tileData.push_back(row);
-    }
-    if (tileData.size() > 0)
-      this->init(tileData, levelWidth, levelHeight);
+  // binary levels are used straight from the mapping
+  if (const auto level = LevelFile::Open(file)) {
+    this->Load(level->Tiles(),
+               level->Columns(),
+               level->Rows(),
+               levelWidth,
+               levelHeight);
+    return;
   }
+  // anything else is read as a text level; an unreadable one is empty
+  const MappedFile text(file);
+  const auto level = text.IsOpen()
+      ? ParseTextLevel(std::string_view(
+            reinterpret_cast<const char*>(text.Data()), text.Size()))
+      : std::nullopt;
+  if (level)
+    this->Load(
+        level->Codes, level->Columns, level->Rows, levelWidth, levelHeight);
+  else
+    this->Load(std::span<const std::uint8_t> {}, 0, 0, levelWidth, levelHeight);
 }
 
-void GameLevel::Draw(SpriteRenderer& renderer)
+void GameLevel::Load(const std::vector<std::vector<unsigned int>>& tileData,
+                     unsigned int levelWidth,
+                     unsigned int levelHeight)
 {
-  for (GameObject& tile : this->Bricks)
-    if (!tile.Destroyed)
-      tile.Draw(renderer);
+  const auto rowCount = static_cast<unsigned int>(tileData.size());
+  const auto columnCount =
+      static_cast<unsigned int>(tileData.empty() ? 0 : tileData[0].size());
+  std::vector<std::uint8_t> codes(std::size_t {columnCount} * rowCount, 0);
+  for (unsigned int y = 0; y < rowCount; ++y)
+    for (unsigned int x = 0; x < columnCount && x < tileData[y].size(); ++x)
+      codes[y * columnCount + x] =
+          static_cast<std::uint8_t>(std::min(tileData[y][x], 255u));
+  this->Load(codes, columnCount, rowCount, levelWidth, levelHeight);
 }
 
-bool GameLevel::IsCompleted()
+void GameLevel::Load(std::span<const std::uint8_t> tiles,
+                     unsigned int columnCount,
+                     unsigned int rowCount,
+                     unsigned int levelWidth,
+                     unsigned int levelHeight)
 {
-  // TODO: Use algorithm?
-  for (GameObject& tile : this->Bricks)
-    if (!tile.IsSolid && !tile.Destroyed)
-      return false;
-  return true;
+  // clear old data
+  this->Bricks = BrickLayout {};
+  this->grid.clear();
+  this->columns = this->rows = 0;
+  if (columnCount > 0 && rowCount > 0
+      && tiles.size() == std::size_t {columnCount} * rowCount)
+    this->init(tiles, columnCount, rowCount, levelWidth, levelHeight);
+  this->alive.Resize(this->Bricks.Count());
+  this->breakable = this->Bricks.Count() - this->Bricks.Solid.Count();
+  this->Reset();
 }
 
-void GameLevel::init(std::vector<std::vector<unsigned int>> tileData,
+bool GameLevel::IsCompleted() const
+{
+  assert(this->remaining == this->CountRemainingBricks());
+  return this->remaining == 0;
+}
+
+void GameLevel::Destroy(std::size_t brick)
+{
+  // solid bricks aren't counted, and a brick is only destroyed once
+  if (this->alive.Test(brick) && !this->Bricks.IsSolid(brick))
+    --this->remaining;
+  this->alive.Clear(brick);
+}
+
+void GameLevel::Reset()
+{
+  this->alive.SetAll();
+  this->remaining = this->breakable;
+}
+
+std::size_t GameLevel::CountRemainingBricks() const
+{
+  // the breakable bricks still standing, 64 at a time
+  const auto standing = this->alive.Words();
+  const auto solid = this->Bricks.Solid.Words();
+  std::size_t count = 0;
+  for (std::size_t i = 0; i < standing.size(); ++i)
+    count += static_cast<std::size_t>(std::popcount(standing[i] & ~solid[i]));
+  return count;
+}
+
+void GameLevel::init(std::span<const std::uint8_t> tiles,
+                     unsigned int width,
+                     unsigned int height,
                      unsigned int levelWidth,
                      unsigned int levelHeight)
 {
   // calculate dimensions
-  unsigned int height = tileData.size();
-  unsigned int width =
-      tileData[0].size();  // note we can index vector at [0] since this
-                           // function is only called if height > 0
   // TODO: Add another static_cast?
   float unit_width = levelWidth / static_cast<float>(width),
         unit_height = levelHeight / height;
-  // initialize level tiles based on tileData
+  // every tile maps to one grid cell
+  this->columns = width;
+  this->rows = height;
+  this->unitSize = glm::vec2(unit_width, unit_height);
+  this->grid.assign(std::size_t {width} * height, noBrick);
+  // every tile code but 0 is a brick
+  const std::size_t count = tiles.size()
+      - static_cast<std::size_t>(std::count(tiles.begin(), tiles.end(), 0));
+  BrickLayout& bricks = this->Bricks;
+  bricks.Size = this->unitSize;
+  bricks.Positions.reserve(count);
+  bricks.Colors.reserve(count);
+  bricks.Types.reserve(count);
+  bricks.Solid.Resize(count);
+  // initialize level tiles based on tile codes
   for (unsigned int y = 0; y < height; ++y) {
     for (unsigned int x = 0; x < width; ++x) {
-      // check block type from level data (2D level array)
-      if (tileData[y][x] == 1)  // solid
-      {
-        // TODO: Reduce duplication around here
-        glm::vec2 pos(unit_width * x, unit_height * y);
-        glm::vec2 size(unit_width, unit_height);
-        GameObject obj(pos,
-                       size,
-                       ResourceManager::GetTexture("block_solid"),
-                       glm::vec3(0.8f, 0.8f, 0.7f));
-        obj.IsSolid = true;
-        this->Bricks.push_back(obj);
-      } else if (tileData[y][x]
-                 > 1)  // non-solid; now determine its color based on level data
-      {
-        // TODO: Create color constants
-        glm::vec3 color = glm::vec3(1.0f);  // original: white
-        if (tileData[y][x] == 2)
-          color = glm::vec3(0.2f, 0.6f, 1.0f);
-        else if (tileData[y][x] == 3)
-          color = glm::vec3(0.0f, 0.7f, 0.0f);
-        else if (tileData[y][x] == 4)
-          color = glm::vec3(0.8f, 0.8f, 0.4f);
-        else if (tileData[y][x] == 5)
-          color = glm::vec3(1.0f, 0.5f, 0.0f);
-
-        glm::vec2 pos(unit_width * x, unit_height * y);
-        glm::vec2 size(unit_width, unit_height);
-        this->Bricks.push_back(
-            GameObject(pos, size, ResourceManager::GetTexture("block"), color));
-      }
-      // TODO: What about other values? Exception?
+      const std::uint8_t code = tiles[std::size_t {y} * width + x];
+      if (code == 0)
+        continue;
+      const std::size_t brick = bricks.Count();
+      this->grid[y * width + x] = static_cast<unsigned int>(brick);
+      bricks.Positions.emplace_back(unit_width * x, unit_height * y);
+      // codes without a color of their own are white
+      bricks.Colors.push_back(
+          code < brickColors.size() ? code : std::uint8_t {0});
+      bricks.Types.push_back(code);
+      if (code == 1)  // solid
+        bricks.Solid.Set(brick);
     }
   }
 }
+
+bool GameLevel::cellRange(float lo,
+                          float hi,
+                          float unit,
+                          unsigned int count,
+                          unsigned int& first,
+                          unsigned int& last)
+{
+  const float extent = unit * static_cast<float>(count);
+  if (count == 0 || unit <= 0.0f || hi < 0.0f || lo >= extent)
+    return false;
+  first = lo <= 0.0f ? 0 : static_cast<unsigned int>(lo / unit);
+  last = hi >= extent ? count - 1 : static_cast<unsigned int>(hi / unit);
+  // guard against rounding at the far edge
+  first = std::min(first, count - 1);
+  last = std::min(last, count - 1);
+  return true;
+}
@@ -8,38 +8,125 @@
 ******************************************************************/
 #ifndef GAMELEVEL_H
 #define GAMELEVEL_H
-#include "game_object.h"
-#include "resource_manager.h"
-#include "sprite_renderer.h"
+#include "bit_set.h"
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <vector>
 
+// The bricks of a level as loaded, as parallel arrays indexed by brick:
+// collision and drawing read little more than the positions, which are
+// packed together. Every brick fills one tile, so they share a size.
+struct BrickLayout
+{
+  // top left corner of each brick
+  std::vector<glm::vec2> Positions;
+  glm::vec2 Size {0.0f};
+  // index into the brick palette, see Color()
+  std::vector<std::uint8_t> Colors;
+  // tile code each brick was loaded from
+  std::vector<std::uint8_t> Types;
+  BitSet Solid;
+
+  std::size_t Count() const { return Positions.size(); }
+  bool IsSolid(std::size_t brick) const { return Solid.Test(brick); }
+  glm::vec3 Color(std::size_t brick) const;
+};
+
 /// GameLevel holds all Tiles as part of a Breakout level and
-/// hosts functionality to Load/render levels from the harddisk.
+/// hosts functionality to Load levels from the harddisk. Rendering is left
+/// to the client (solid bricks use "block_solid", all others "block").
+/// The bricks are kept as loaded; which of them are still standing is a bit
+/// per brick, so Reset() starts the level over without loading it.
 class GameLevel
 {
 public:
-  // level state
-  std::vector<GameObject> Bricks;
+  // the bricks as loaded, never changed while playing
+  BrickLayout Bricks;
   // constructor
   GameLevel() {}
-  // loads level from file
+  // loads level from a binary level file (see LevelFile) or a text one
   void Load(const char* file,
             unsigned int levelWidth,
             unsigned int levelHeight);
-  // render level
-  void Draw(SpriteRenderer& renderer);
-  // check if the level is completed (all non-solid tiles are destroyed)
-  bool IsCompleted();
+  // loads level from tile data, one vector of tile codes per row
+  void Load(const std::vector<std::vector<unsigned int>>& tileData,
+            unsigned int levelWidth,
+            unsigned int levelHeight);
+  // loads level from columns x rows tile codes, row by row
+  void Load(std::span<const std::uint8_t> tiles,
+            unsigned int columnCount,
+            unsigned int rowCount,
+            unsigned int levelWidth,
+            unsigned int levelHeight);
+  // check if the level is completed (all non-solid tiles are destroyed); in
+  // debug builds the count it checks is compared with a full scan
+  bool IsCompleted() const;
+  // number of non-solid bricks not destroyed yet, kept up to date by
+  // Destroy() and Reset()
+  std::size_t RemainingBricks() const { return remaining; }
+  // the same number counted from the bricks, in O(bricks / 64)
+  std::size_t CountRemainingBricks() const;
+
+  // state of the brick at an index into Bricks
+  bool IsDestroyed(std::size_t brick) const { return !alive.Test(brick); }
+  void Destroy(std::size_t brick);
+  // brings all bricks back, in O(bricks / 64)
+  void Reset();
+  // a set bit for every brick that is not destroyed
+  const BitSet& AliveBricks() const { return alive; }
+
+  // calls fn(index) for each brick that is not destroyed and whose tile
+  // overlaps the box spanned by min and max, in row-major order
+  template<typename Fn>
+  void ForEachBrickIn(glm::vec2 min, glm::vec2 max, Fn&& fn) const;
 
 private:
-  // initialize level from tile data
-  void init(std::vector<std::vector<unsigned int>> tileData,
+  // initialize level from tile codes
+  void init(std::span<const std::uint8_t> tiles,
+            unsigned int width,
+            unsigned int height,
             unsigned int levelWidth,
             unsigned int levelHeight);
+  // range of cells [first, last] covered by [lo, hi] along one axis; false if
+  // the range misses the grid
+  static bool cellRange(float lo,
+                        float hi,
+                        float unit,
+                        unsigned int count,
+                        unsigned int& first,
+                        unsigned int& last);
+
+  // Broadphase: the tile grid the bricks were laid out on, holding the index
+  // into Bricks of each cell's brick
+  static constexpr unsigned int noBrick = ~0u;
+  std::vector<unsigned int> grid;
+  unsigned int columns = 0;
+  unsigned int rows = 0;
+  glm::vec2 unitSize {0.0f};
+  BitSet alive;
+  // non-solid bricks in the level and how many of them are left
+  std::size_t breakable = 0;
+  std::size_t remaining = 0;
 };
 
+template<typename Fn>
+void GameLevel::ForEachBrickIn(glm::vec2 min, glm::vec2 max, Fn&& fn) const
+{
+  unsigned int firstX, lastX, firstY, lastY;
+  if (!cellRange(min.x, max.x, this->unitSize.x, this->columns, firstX, lastX)
+      || !cellRange(min.y, max.y, this->unitSize.y, this->rows, firstY, lastY))
+    return;
+  for (unsigned int y = firstY; y <= lastY; ++y) {
+    for (unsigned int x = firstX; x <= lastX; ++x) {
+      const unsigned int brick = this->grid[y * this->columns + x];
+      if (brick != noBrick && this->alive.Test(brick))
+        fn(brick);
+    }
+  }
+}
+
 #endif
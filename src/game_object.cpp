@@ -10,19 +10,11 @@
 
 GameObject::GameObject(glm::vec2 pos,
                        glm::vec2 size,
-                       Texture2D sprite,
                        glm::vec3 color,
                        glm::vec2 velocity)
     : Position(pos)
     , Size(size)
     , Velocity(velocity)
     , Color(color)
-    , Sprite(sprite)
 {
 }
-
-void GameObject::Draw(SpriteRenderer& renderer)
-{
-  renderer.DrawSprite(
-      this->Sprite, this->Position, this->Size, this->Rotation, this->Color);
-}
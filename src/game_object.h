@@ -9,15 +9,13 @@
 #ifndef GAMEOBJECT_H
 #define GAMEOBJECT_H
 
-#include "sprite_renderer.h"
-#include "texture.h"
-
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
 // Container object for holding all state relevant for a single
 // game object entity. Each object in the game likely needs the
 // minimal of state as described within GameObject.
+// GameObject carries no render state; renderers pick the sprite to draw it
+// with, so the simulation can run without a GL context.
 struct GameObject
 {
   // constructor(s)
@@ -25,11 +23,8 @@ struct GameObject
   // TODO: Consider reorder parameters to match member variable order.
   GameObject(glm::vec2 pos,
              glm::vec2 size,
-             Texture2D sprite,
              glm::vec3 color = glm::vec3(1.0f),
              glm::vec2 velocity = glm::vec2(0.0f, 0.0f));
-  // draw sprite
-  virtual void Draw(SpriteRenderer& renderer);
 
   // Data
   // Object state
@@ -42,9 +37,6 @@ struct GameObject
 
   bool IsSolid = false;
   bool Destroyed = false;
-
-  // Render state
-  Texture2D Sprite {};
 };
 
 #endif
@@ -0,0 +1,256 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "glyph_atlas.h"
+
+#include "hash.h"
+#include "texture_atlas.h"
+
+#include <ft2build.h>
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Bump whenever the cache file layout or the glyph rendering changes
+constexpr std::uint32_t formatVersion = 1;
+constexpr char magic[8] = {'B', 'K', 'G', 'L', 'Y', 'P', 'H', 'S'};
+
+// A glyph as rendered by FreeType, before packing
+struct RenderedGlyph
+{
+  std::vector<unsigned char> Pixels;
+  unsigned int Width = 0;
+  unsigned int Rows = 0;
+  int Left = 0;
+  int Top = 0;
+  unsigned int Advance = 0;
+};
+
+// Renders the glyphs claimed from next until all are done; one FreeType
+// library and face per call, since neither may be shared between threads
+bool renderGlyphs(const std::string& font,
+                  unsigned int fontSize,
+                  GlyphMode mode,
+                  std::vector<RenderedGlyph>& glyphs,
+                  std::atomic<unsigned int>& next)
+{
+  FT_Library ft;
+  if (FT_Init_FreeType(&ft)) {
+    std::cout << "ERROR::FREETYPE: Could not init FreeType Library"
+              << std::endl;
+    return false;
+  }
+  FT_Face face;
+  if (FT_New_Face(ft, font.c_str(), 0, &face)) {
+    std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
+    FT_Done_FreeType(ft);
+    return false;
+  }
+  FT_Set_Pixel_Sizes(face, 0, fontSize);
+  if (mode == GlyphMode::SDF) {
+    FT_Int spread = glyphSdfSpread;
+    FT_Property_Set(ft, "sdf", "spread", &spread);
+  }
+  const FT_Render_Mode renderMode =
+      mode == GlyphMode::SDF ? FT_RENDER_MODE_SDF : FT_RENDER_MODE_NORMAL;
+
+  for (unsigned int c = next++; c < glyphs.size(); c = next++) {
+    if (FT_Load_Char(face, c, FT_LOAD_DEFAULT)
+        || FT_Render_Glyph(face->glyph, renderMode))
+    {
+      std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+      continue;
+    }
+    const FT_Bitmap& bitmap = face->glyph->bitmap;
+    RenderedGlyph& glyph = glyphs[c];
+    // rows of a FreeType bitmap may be padded, the atlas wants them packed
+    glyph.Pixels.resize(std::size_t {bitmap.width} * bitmap.rows);
+    for (unsigned int row = 0; row < bitmap.rows; ++row)
+      std::memcpy(glyph.Pixels.data() + row * bitmap.width,
+                  bitmap.buffer + static_cast<long>(row) * bitmap.pitch,
+                  bitmap.width);
+    glyph.Width = bitmap.width;
+    glyph.Rows = bitmap.rows;
+    glyph.Left = face->glyph->bitmap_left;
+    glyph.Top = face->glyph->bitmap_top;
+    glyph.Advance = static_cast<unsigned int>(face->glyph->advance.x);
+  }
+
+  FT_Done_Face(face);
+  FT_Done_FreeType(ft);
+  return true;
+}
+
+template<typename T>
+void write(std::ostream& out, const T& value)
+{
+  out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template<typename T>
+bool read(std::istream& in, T& value)
+{
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+}  // namespace
+
+std::optional<GlyphAtlas> BuildGlyphAtlas(const std::string& font,
+                                          unsigned int fontSize,
+                                          GlyphMode mode,
+                                          unsigned int threads)
+{
+  GlyphAtlas atlas;
+  std::vector<RenderedGlyph> glyphs(atlas.Characters.size());
+  if (threads == 0)
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<unsigned int>(
+      threads, static_cast<unsigned int>(glyphs.size()));
+
+  // the glyphs are handed out one at a time, so threads that get simple ones
+  // take more
+  std::atomic<unsigned int> next {0};
+  std::vector<char> succeeded(threads, 0);
+  std::vector<std::thread> workers;
+  for (unsigned int i = 1; i < threads; ++i)
+    workers.emplace_back(
+        [&, i]
+        { succeeded[i] = renderGlyphs(font, fontSize, mode, glyphs, next); });
+  succeeded[0] = renderGlyphs(font, fontSize, mode, glyphs, next);
+  for (std::thread& worker : workers)
+    worker.join();
+  if (std::find(succeeded.begin(), succeeded.end(), 0) != succeeded.end())
+    return std::nullopt;
+
+  // pack all glyphs into one texture; SDF glyphs carry their own margin
+  const unsigned int padding = mode == GlyphMode::SDF ? 0 : 1;
+  std::vector<AtlasRect> sizes;
+  for (const RenderedGlyph& glyph : glyphs)
+    sizes.push_back(AtlasRect {0, 0, glyph.Width, glyph.Rows});
+  const auto layout = PackAtlas(sizes, padding, 8192);
+  if (!layout) {
+    std::cout << "ERROR::FREETYPE: Glyphs don't fit into a texture"
+              << std::endl;
+    return std::nullopt;
+  }
+  atlas.Width = layout->Width;
+  atlas.Height = layout->Height;
+  atlas.Pixels.assign(std::size_t {atlas.Width} * atlas.Height, 0);
+  const auto atlasWidth = static_cast<float>(atlas.Width);
+  const auto atlasHeight = static_cast<float>(atlas.Height);
+  for (std::size_t c = 0; c < glyphs.size(); c++) {
+    const RenderedGlyph& glyph = glyphs[c];
+    const AtlasRect& rect = layout->Rects[c];
+    CopyIntoAtlas(
+        atlas.Pixels, atlas.Width, glyph.Pixels.data(), rect, padding, 1);
+    atlas.Characters[c] = Character {
+        glm::vec4(static_cast<float>(rect.X) / atlasWidth,
+                  static_cast<float>(rect.Y) / atlasHeight,
+                  static_cast<float>(rect.Width) / atlasWidth,
+                  static_cast<float>(rect.Height) / atlasHeight),
+        glm::ivec2(glyph.Width, glyph.Rows),
+        glm::ivec2(glyph.Left, glyph.Top),
+        glyph.Advance};
+  }
+  return atlas;
+}
+
+std::uint64_t GlyphAtlasKey(const std::string& font,
+                            unsigned int fontSize,
+                            GlyphMode mode)
+{
+  std::uint64_t hash = HashBytes(&formatVersion, sizeof(formatVersion));
+  hash = HashBytes(font.data(), font.size(), hash);
+  hash = HashBytes(&fontSize, sizeof(fontSize), hash);
+  hash = HashBytes(&mode, sizeof(mode), hash);
+  hash = HashBytes(&glyphSdfSpread, sizeof(glyphSdfSpread), hash);
+  // a changed font file gets a new key
+  std::error_code error;
+  const auto size = fs::file_size(font, error);
+  hash = HashBytes(&size, sizeof(size), hash);
+  const auto modified = fs::last_write_time(font, error).time_since_epoch();
+  const auto ticks = modified.count();
+  hash = HashBytes(&ticks, sizeof(ticks), hash);
+  return hash;
+}
+
+bool SaveGlyphAtlas(const GlyphAtlas& atlas,
+                    std::uint64_t key,
+                    const fs::path& path)
+{
+  std::error_code error;
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path(), error);
+  // write next to the target and rename, so a crash never leaves a
+  // half-written cache behind
+  fs::path temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    out.write(magic, sizeof(magic));
+    write(out, formatVersion);
+    write(out, key);
+    write(out, atlas.Width);
+    write(out, atlas.Height);
+    for (const Character& ch : atlas.Characters) {
+      write(out, ch.TexRect);
+      write(out, ch.Size);
+      write(out, ch.Bearing);
+      write(out, ch.Advance);
+    }
+    out.write(reinterpret_cast<const char*>(atlas.Pixels.data()),
+              static_cast<std::streamsize>(atlas.Pixels.size()));
+    if (!out)
+      return false;
+  }
+  fs::rename(temporary, path, error);
+  return !error;
+}
+
+std::optional<GlyphAtlas> LoadGlyphAtlas(std::uint64_t key,
+                                         const fs::path& path)
+{
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return std::nullopt;
+  char header[sizeof(magic)];
+  std::uint32_t version = 0;
+  std::uint64_t savedKey = 0;
+  GlyphAtlas atlas;
+  if (!in.read(header, sizeof(header))
+      || std::memcmp(header, magic, sizeof(magic)) != 0 || !read(in, version)
+      || version != formatVersion || !read(in, savedKey) || savedKey != key
+      || !read(in, atlas.Width) || !read(in, atlas.Height))
+    return std::nullopt;
+  // refuse sizes no packer would have produced rather than allocating them
+  if (atlas.Width == 0 || atlas.Height == 0 || atlas.Width > 8192
+      || atlas.Height > 8192)
+    return std::nullopt;
+  for (Character& ch : atlas.Characters)
+    if (!read(in, ch.TexRect) || !read(in, ch.Size) || !read(in, ch.Bearing)
+        || !read(in, ch.Advance))
+      return std::nullopt;
+  atlas.Pixels.resize(std::size_t {atlas.Width} * atlas.Height);
+  if (!in.read(reinterpret_cast<char*>(atlas.Pixels.data()),
+               static_cast<std::streamsize>(atlas.Pixels.size())))
+    return std::nullopt;
+  return atlas;
+}
@@ -0,0 +1,77 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef GLYPH_ATLAS_H
+#define GLYPH_ATLAS_H
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+/// Holds all state information relevant to a character as loaded using FreeType
+struct Character
+{
+  glm::vec4 TexRect;  // <vec2 uv offset, vec2 uv scale> in the glyph atlas
+  glm::ivec2 Size;  // size of glyph
+  glm::ivec2 Bearing;  // offset from baseline to left/top of glyph
+  unsigned int Advance;  // horizontal offset to advance to next glyph
+};
+
+// How glyphs are stored in the atlas
+enum class GlyphMode
+{
+  // coverage bitmaps; sharp at the loaded size, blurry when scaled up
+  Bitmap,
+  // signed distance fields: 128 on the outline, more inside, less outside;
+  // one size renders sharp edges at any scale
+  SDF
+};
+
+// The first 128 characters of a font rasterized and packed into a single
+// channel texture
+struct GlyphAtlas
+{
+  unsigned int Width = 0;
+  unsigned int Height = 0;
+  std::vector<unsigned char> Pixels;
+  std::array<Character, 128> Characters {};
+};
+
+// Distance in pixels an SDF glyph's field reaches beyond its outline; also
+// the margin around each SDF glyph
+constexpr unsigned int glyphSdfSpread = 8;
+
+// Rasterizes and packs the glyphs of a font file at the given pixel size.
+// Glyphs are rendered in parallel on up to threads threads (0 picks one per
+// core), each with its own FreeType face. Nothing if the font can't be read.
+std::optional<GlyphAtlas> BuildGlyphAtlas(const std::string& font,
+                                          unsigned int fontSize,
+                                          GlyphMode mode,
+                                          unsigned int threads = 0);
+
+// Identifies an atlas built from the font file as it is now; changes when the
+// file, the size, the mode or the atlas format change
+std::uint64_t GlyphAtlasKey(const std::string& font,
+                            unsigned int fontSize,
+                            GlyphMode mode);
+
+// Writes an atlas to a cache file; false on failure
+bool SaveGlyphAtlas(const GlyphAtlas& atlas,
+                    std::uint64_t key,
+                    const std::filesystem::path& path);
+// Reads an atlas back; nothing if the file is missing, damaged or was saved
+// under another key
+std::optional<GlyphAtlas> LoadGlyphAtlas(std::uint64_t key,
+                                         const std::filesystem::path& path);
+
+#endif
@@ -0,0 +1,67 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef HASH_H
+#define HASH_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// Mixes the bits of a 64-bit value so every input bit affects every output
+// bit (the finalizer of MurmurHash3)
+constexpr std::uint64_t MixBits(std::uint64_t value)
+{
+  value ^= value >> 33;
+  value *= 0xff51afd7ed558ccdull;
+  value ^= value >> 33;
+  value *= 0xc4ceb9fe1a85ec53ull;
+  value ^= value >> 33;
+  return value;
+}
+
+// Hashes a block of memory 8 bytes at a time, fast enough for the contents of
+// whole asset files. Not for hash tables facing untrusted input, and the
+// result depends on the byte order of the machine.
+inline std::uint64_t HashBytes(const void* data,
+                               std::size_t size,
+                               std::uint64_t seed = 0)
+{
+  constexpr std::uint64_t k1 = 0x87c37b91114253d5ull;
+  constexpr std::uint64_t k2 = 0x4cf5ad432745937full;
+  const auto* bytes = static_cast<const unsigned char*>(data);
+  std::uint64_t hash = seed ^ (size * k1);
+  std::size_t i = 0;
+  for (; i + 8 <= size; i += 8) {
+    std::uint64_t word;
+    std::memcpy(&word, bytes + i, 8);
+    hash = std::rotl(hash ^ (word * k1), 31) * k2;
+  }
+  // the last 0 to 7 bytes
+  std::uint64_t tail = 0;
+  if (i < size)
+    std::memcpy(&tail, bytes + i, size - i);
+  hash = std::rotl(hash ^ (tail * k1), 31) * k2;
+  return MixBits(hash);
+}
+
+// Hashes a string with FNV-1a 64, one byte at a time. Slower than HashBytes,
+// but the compiler can evaluate it, for names known at compile time.
+constexpr std::uint64_t HashString(std::string_view text)
+{
+  std::uint64_t hash = 0xcbf29ce484222325ull;
+  for (char c : text) {
+    hash ^= static_cast<unsigned char>(c);
+    hash *= 0x100000001b3ull;
+  }
+  return MixBits(hash);
+}
+
+#endif
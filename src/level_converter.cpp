@@ -0,0 +1,59 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "level_file.h"
+#include "mapped_file.h"
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Converts a level from the text format into the binary one the game maps:
+//
+//   Breakout_level_converter <input.lvl> <output.blvl> [key=value ...]
+//
+// The key=value arguments are stored as the level's metadata, one per line.
+int main(int argc, char* argv[])
+{
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <input.lvl> <output.blvl> [key=value ...]\n";
+    return 2;
+  }
+  const std::filesystem::path input = argv[1];
+  const std::filesystem::path output = argv[2];
+  std::string metadata;
+  for (int i = 3; i < argc; ++i) {
+    const std::string_view entry = argv[i];
+    if (entry.find('=') == std::string_view::npos) {
+      std::cerr << "Metadata must be given as key=value, not " << entry
+                << '\n';
+      return 2;
+    }
+    metadata.append(entry).push_back('\n');
+  }
+
+  const MappedFile text(input);
+  if (!text.IsOpen()) {
+    std::cerr << "Could not read " << input.string() << '\n';
+    return 1;
+  }
+  const auto level = ParseTextLevel(std::string_view(
+      reinterpret_cast<const char*>(text.Data()), text.Size()));
+  if (!level) {
+    std::cerr << input.string()
+              << ": tile codes must be numbers from 0 to 255\n";
+    return 1;
+  }
+  if (!SaveLevelFile(*level, metadata, output)) {
+    std::cerr << "Could not write " << output.string() << '\n';
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,147 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "level_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Bump whenever the file layout changes
+constexpr std::uint32_t formatVersion = 1;
+constexpr char magic[8] = {'B', 'K', 'L', 'E', 'V', 'E', 'L', '\0'};
+// Largest number of columns or rows a level file may claim
+constexpr unsigned int maxSize = 1u << 16;
+
+struct FileHeader
+{
+  char Magic[8];
+  std::uint32_t Version;
+  std::uint32_t Columns;
+  std::uint32_t Rows;
+  std::uint32_t MetadataSize;
+};
+
+bool isSpace(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+}  // namespace
+
+std::optional<LevelFile> LevelFile::Open(const fs::path& path)
+{
+  MappedFile mapped(path);
+  FileHeader header {};
+  if (!mapped.IsOpen() || mapped.Size() < sizeof(header))
+    return std::nullopt;
+  std::memcpy(&header, mapped.Data(), sizeof(header));
+  if (std::memcmp(header.Magic, magic, sizeof(magic)) != 0
+      || header.Version != formatVersion || header.Columns > maxSize
+      || header.Rows > maxSize)
+    return std::nullopt;
+  const std::size_t tileCount = std::size_t {header.Columns} * header.Rows;
+  if (mapped.Size() - sizeof(header) < tileCount
+      || mapped.Size() - sizeof(header) - tileCount < header.MetadataSize)
+    return std::nullopt;
+
+  LevelFile level;
+  level.columns = header.Columns;
+  level.rows = header.Rows;
+  const unsigned char* data = mapped.Data() + sizeof(header);
+  level.tiles = std::span<const std::uint8_t>(data, tileCount);
+  level.metadata = std::string_view(
+      reinterpret_cast<const char*>(data + tileCount), header.MetadataSize);
+  // the views point into the mapping, which moving the file doesn't move
+  level.file = std::move(mapped);
+  return level;
+}
+
+bool SaveLevelFile(const LevelTiles& level,
+                   std::string_view metadata,
+                   const fs::path& path)
+{
+  if (level.Codes.size() != std::size_t {level.Columns} * level.Rows
+      || level.Columns > maxSize || level.Rows > maxSize)
+    return false;
+  std::error_code error;
+  // write next to the target and rename, so a reader never maps a
+  // half-written level
+  fs::path temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    FileHeader header {};
+    std::memcpy(header.Magic, magic, sizeof(magic));
+    header.Version = formatVersion;
+    header.Columns = level.Columns;
+    header.Rows = level.Rows;
+    header.MetadataSize = static_cast<std::uint32_t>(metadata.size());
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(level.Codes.data()),
+              static_cast<std::streamsize>(level.Codes.size()));
+    out.write(metadata.data(), static_cast<std::streamsize>(metadata.size()));
+    if (!out)
+      return false;
+  }
+  fs::rename(temporary, path, error);
+  return !error;
+}
+
+std::optional<LevelTiles> ParseTextLevel(std::string_view text)
+{
+  LevelTiles level;
+  std::vector<std::size_t> rowEnds;
+  const char* pos = text.data();
+  const char* const end = text.data() + text.size();
+  while (pos < end) {
+    const char* const lineEnd = std::find(pos, end, '\n');
+    const std::size_t rowStart = level.Codes.size();
+    while (pos < lineEnd) {
+      if (isSpace(*pos)) {
+        ++pos;
+        continue;
+      }
+      unsigned int code = 0;
+      const auto [next, error] = std::from_chars(pos, lineEnd, code);
+      if (error != std::errc {} || code > 255
+          || (next < lineEnd && !isSpace(*next)))
+        return std::nullopt;
+      level.Codes.push_back(static_cast<std::uint8_t>(code));
+      pos = next;
+    }
+    pos = lineEnd + (lineEnd < end ? 1 : 0);
+    const std::size_t length = level.Codes.size() - rowStart;
+    if (length > 0) {
+      rowEnds.push_back(level.Codes.size());
+      level.Columns =
+          std::max(level.Columns, static_cast<unsigned int>(length));
+    }
+  }
+  level.Rows = static_cast<unsigned int>(rowEnds.size());
+  // lay the rows out at the full width, back to front so no row is
+  // overwritten before it was moved
+  level.Codes.resize(std::size_t {level.Columns} * level.Rows, 0);
+  std::uint8_t* const codes = level.Codes.data();
+  for (std::size_t row = level.Rows; row-- > 0;) {
+    const std::size_t start = row == 0 ? 0 : rowEnds[row - 1];
+    const std::size_t target = row * level.Columns;
+    const std::size_t length = rowEnds[row] - start;
+    std::copy_backward(
+        codes + start, codes + rowEnds[row], codes + target + length);
+    std::fill(codes + target + length, codes + target + level.Columns, 0);
+  }
+  return level;
+}
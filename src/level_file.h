@@ -0,0 +1,67 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef LEVEL_FILE_H
+#define LEVEL_FILE_H
+
+#include "mapped_file.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+// The tile codes of a level, row by row from the top, one byte per tile: 0
+// is empty, 1 a solid brick and 2 and up breakable bricks of some color
+struct LevelTiles
+{
+  unsigned int Columns = 0;
+  unsigned int Rows = 0;
+  std::vector<std::uint8_t> Codes;
+};
+
+// LevelFile is a level in the binary format, mapped into memory. A header -
+// magic, version, columns, rows and the size of the metadata - is followed
+// by the tile codes, one byte per tile row by row, and by optional metadata,
+// free-form text of key=value lines. Tiles and metadata are views into the
+// mapping; opening a level reads nothing but the header.
+class LevelFile
+{
+public:
+  // Maps the file; nothing if it isn't a level of this format version or is
+  // cut short
+  static std::optional<LevelFile> Open(const std::filesystem::path& path);
+
+  unsigned int Columns() const { return columns; }
+  unsigned int Rows() const { return rows; }
+  std::span<const std::uint8_t> Tiles() const { return tiles; }
+  std::string_view Metadata() const { return metadata; }
+
+private:
+  LevelFile() = default;
+
+  MappedFile file;
+  unsigned int columns = 0;
+  unsigned int rows = 0;
+  std::span<const std::uint8_t> tiles;
+  std::string_view metadata;
+};
+
+// Writes a level in the binary format; false if it couldn't be written
+bool SaveLevelFile(const LevelTiles& level,
+                   std::string_view metadata,
+                   const std::filesystem::path& path);
+
+// Parses a level in the text format: one line of whitespace separated tile
+// codes per row, blank lines are skipped and short rows filled up with empty
+// tiles. Nothing if a code isn't a number below 256.
+std::optional<LevelTiles> ParseTextLevel(std::string_view text);
+
+#endif
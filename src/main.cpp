@@ -6,6 +6,7 @@
 ** Creative Commons, either version 4 of the License, or (at your
 ** option) any later version.
 ******************************************************************/
+#include "frame_timing.h"
 #include "game.h"
 #include "resource_manager.h"
 
@@ -14,7 +15,16 @@
 #include <GLFW/glfw3.h>
 // clang-format on
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
 #include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
 
 // GLFW function declarations
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
@@ -27,8 +37,42 @@ const unsigned int SCREEN_WIDTH = 800;
 // The height of the screen
 const unsigned int SCREEN_HEIGHT = 600;
 
+// How frames are paced
+enum class PresentMode
+{
+  VSync,  // wait for the display's refresh
+  Limited,  // sleep to a target frame rate
+  Unlimited  // render as fast as possible
+};
+
+// Game loop settings, configurable from the command line
+struct LoopOptions
+{
+  double TickRate = 120.0;
+  // ticks the simulation thread may run at once to catch up
+  unsigned int MaxTicksPerFrame = 8;
+  PresentMode Present = PresentMode::VSync;
+  double FrameRateLimit = 144.0;
+  // seconds between frame timing reports, 0 to disable
+  double StatsInterval = 0.0;
+  // load shaders, textures and levels again when their files change
+  bool HotReload = false;
+  // seed of the game's random numbers; a random one if not given
+  std::optional<std::uint64_t> Seed;
+  // file to record the game's keys to, for replaying it headless
+  std::string RecordFile;
+};
+
+LoopOptions parse_options(int argc, char* argv[]);
+void run_simulation(Game& game,
+                    LoopOptions options,
+                    const std::atomic<bool>& running);
+void wait_for_frame_end(double frameStart, double frameRate);
+
 int main(int argc, char* argv[])
 {
+  const LoopOptions options = parse_options(argc, argv);
+
   glfwInit();
   glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
   glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -47,6 +91,7 @@ int main(int argc, char* argv[])
     return -1;
   }
   glfwMakeContextCurrent(window);
+  glfwSwapInterval(options.Present == PresentMode::VSync ? 1 : 0);
 
   // glad: load all OpenGL function pointers
   // ---------------------------------------
@@ -61,8 +106,12 @@ int main(int argc, char* argv[])
   glEnable(GL_BLEND);
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-  // Requires OpenGL to be initialized
-  Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT);
+  // Requires OpenGL to be initialized; the seed is printed so a game can be
+  // played again with --seed
+  const std::uint64_t seed =
+      options.Seed ? *options.Seed : std::random_device {}();
+  std::cout << "seed: " << seed << std::endl;
+  Game Breakout(SCREEN_WIDTH, SCREEN_HEIGHT, seed);
 
   // Set pointer for callback to call Breakout methods
   glfwSetWindowUserPointer(window, &Breakout);
@@ -74,37 +123,80 @@ int main(int argc, char* argv[])
   // initialize game
   // ---------------
   Breakout.Init();
+  if (options.HotReload)
+    Breakout.WatchAssets();
+  // recorded from the first tick, with the tick length the simulation thread
+  // will step by
+  const bool recording = !options.RecordFile.empty()
+      && Breakout.Record(options.RecordFile,
+                         FixedTimestep(options.TickRate).TickSeconds());
+
+  // start simulating
+  // ----------------
+  std::atomic<bool> running {true};
+  std::thread simulation(
+      run_simulation, std::ref(Breakout), options, std::cref(running));
 
-  // deltaTime variables
-  // -------------------
-  float deltaTime = 0.0f;
-  float lastFrame = 0.0f;
+  // timing
+  // ------
+  FrameStats stats;
+  double lastFrame = glfwGetTime();
+  unsigned long long lastTicks = 0;
+  double lastSimSeconds = 0.0;
+  unsigned long long textureBinds = 0;
 
   while (!glfwWindowShouldClose(window)) {
-    // calculate delta time
+    // calculate frame time
     // --------------------
-    float currentFrame = glfwGetTime();
-    deltaTime = currentFrame - lastFrame;
-    lastFrame = currentFrame;
-    glfwPollEvents();
+    const double frameStart = glfwGetTime();
+    const double frameTime = frameStart - lastFrame;
+    lastFrame = frameStart;
 
-    // manage user input
-    // -----------------
-    Breakout.ProcessInput(deltaTime);
+    // forward input to the simulation thread
+    // --------------------------------------
+    glfwPollEvents();
 
-    // update game state
-    // -----------------
-    Breakout.Update(deltaTime);
+    // swap in edited assets, with --hot-reload
+    // ----------------------------------------
+    Breakout.ReloadChangedAssets();
 
-    // render
-    // ------
+    // render the newest simulated state
+    // ---------------------------------
     glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT);
-    Breakout.Render();
+    Breakout.Render(frameStart);
 
     glfwSwapBuffers(window);
+    if (options.Present == PresentMode::Limited)
+      wait_for_frame_end(frameStart, options.FrameRateLimit);
+
+    // report frame timing; the simulation's progress is read from the
+    // snapshots, so frame rate and tick rate are measured independently
+    // ------------------------------------------------------------------
+    const unsigned long long ticks = Breakout.TicksSimulated();
+    const double simSeconds = Breakout.SecondsSimulating();
+    stats.AddFrame(frameTime,
+                   simSeconds - lastSimSeconds,
+                   static_cast<unsigned int>(ticks - lastTicks));
+    lastTicks = ticks;
+    lastSimSeconds = simSeconds;
+    textureBinds += Breakout.TextureBinds();
+    if (options.StatsInterval > 0.0 && stats.Elapsed() >= options.StatsInterval)
+    {
+      stats.Report(std::cout);
+      std::cout << "render: "
+                << static_cast<double>(textureBinds) / stats.Frames()
+                << " texture binds per frame\n";
+      stats.Reset();
+      textureBinds = 0;
+    }
   }
 
+  running.store(false, std::memory_order_relaxed);
+  simulation.join();
+  if (recording)
+    Breakout.StopRecording();
+
   // delete all resources as loaded using the resource manager
   // ---------------------------------------------------------
   ResourceManager::Clear();
@@ -113,6 +205,84 @@ int main(int argc, char* argv[])
   return 0;
 }
 
+// Reads --tick-rate=<hz>, --max-ticks=<n>, --present=vsync|unlimited|<fps>,
+// --stats[=<seconds>], --hot-reload, --seed=<n> and --record=<file>; unknown
+// or invalid arguments are reported and ignored
+LoopOptions parse_options(int argc, char* argv[])
+{
+  LoopOptions options;
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg = argv[i];
+    const auto equals = arg.find('=');
+    const std::string name = arg.substr(0, equals);
+    const std::string value =
+        equals == std::string::npos ? "" : arg.substr(equals + 1);
+    const double number = std::atof(value.c_str());
+    if (name == "--tick-rate" && number > 0.0) {
+      options.TickRate = number;
+    } else if (name == "--max-ticks" && number >= 1.0) {
+      options.MaxTicksPerFrame = static_cast<unsigned int>(number);
+    } else if (name == "--present" && value == "vsync") {
+      options.Present = PresentMode::VSync;
+    } else if (name == "--present" && value == "unlimited") {
+      options.Present = PresentMode::Unlimited;
+    } else if (name == "--present" && number > 0.0) {
+      options.Present = PresentMode::Limited;
+      options.FrameRateLimit = number;
+    } else if (name == "--stats") {
+      options.StatsInterval = number > 0.0 ? number : 5.0;
+    } else if (arg == "--hot-reload") {
+      options.HotReload = true;
+    } else if (name == "--seed" && !value.empty()
+               && value.find_first_not_of("0123456789") == std::string::npos)
+    {
+      options.Seed = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (name == "--record" && !value.empty()) {
+      options.RecordFile = value;
+    } else {
+      std::cerr << "Ignoring unknown or invalid option " << arg << '\n';
+    }
+  }
+  return options;
+}
+
+// Simulation thread: runs fixed ticks as they fall due until running is
+// cleared, sleeping in between
+void run_simulation(Game& game,
+                    LoopOptions options,
+                    const std::atomic<bool>& running)
+{
+  FixedTimestep timestep(options.TickRate, options.MaxTicksPerFrame);
+  double last = glfwGetTime();
+  while (running.load(std::memory_order_relaxed)) {
+    const double now = glfwGetTime();
+    const unsigned int ticks = timestep.Advance(now - last);
+    last = now;
+    for (unsigned int i = 0; i < ticks; ++i)
+      game.Update(timestep.TickSeconds());
+    // sleep until the next tick is due
+    std::this_thread::sleep_for(std::chrono::duration<double>(
+        (1.0f - timestep.Alpha()) * timestep.TickSeconds()));
+  }
+  if (options.StatsInterval > 0.0 && timestep.DroppedTicks() > 0)
+    std::cout << "sim: " << timestep.DroppedTicks()
+              << " ticks dropped, consider a lower tick rate\n";
+}
+
+// Sleeps until 1 / frameRate seconds have passed since frameStart. Sleeping
+// overshoots by up to a scheduler tick, so the last two milliseconds are spun.
+void wait_for_frame_end(double frameStart, double frameRate)
+{
+  const double frameEnd = frameStart + 1.0 / frameRate;
+  const double spin = 0.002;
+  const double remaining = frameEnd - glfwGetTime();
+  if (remaining > spin)
+    std::this_thread::sleep_for(
+        std::chrono::duration<double>(remaining - spin));
+  while (glfwGetTime() < frameEnd) {
+  }
+}
+
 void key_callback(
     GLFWwindow* window, int key, int scancode, int action, int mode)
 {
@@ -122,14 +292,9 @@ void key_callback(
   // to true, closing the application
   if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS)
     glfwSetWindowShouldClose(window, true);
-  if (key >= 0 && key < 1024) {
-    if (action == GLFW_PRESS)
-      game.Keys[key] = true;
-    else if (action == GLFW_RELEASE) {
-      game.Keys[key] = false;
-      game.KeysProcessed[key] = false;
-    }
-  }
+  // the simulation thread picks the key up on its next tick
+  if (action == GLFW_PRESS || action == GLFW_RELEASE)
+    game.PostKey(key, action == GLFW_PRESS);
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
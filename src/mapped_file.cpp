@@ -0,0 +1,113 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "mapped_file.h"
+
+#include <utility>
+
+#if defined(_WIN32)
+#  define WIN32_LEAN_AND_MEAN
+#  define NOMINMAX
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::filesystem::path& path)
+{
+#if defined(_WIN32)
+  HANDLE file = CreateFileW(path.c_str(),
+                            GENERIC_READ,
+                            FILE_SHARE_READ,
+                            nullptr,
+                            OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL,
+                            nullptr);
+  if (file == INVALID_HANDLE_VALUE)
+    return;
+  LARGE_INTEGER fileSize;
+  if (GetFileSizeEx(file, &fileSize)) {
+    this->size = static_cast<std::size_t>(fileSize.QuadPart);
+    this->open = true;
+    // an empty file can't be mapped, but it is a valid empty view
+    if (this->size > 0) {
+      HANDLE mapping =
+          CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+      void* view = mapping != nullptr
+          ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)
+          : nullptr;
+      // the view keeps the mapping alive
+      if (mapping != nullptr)
+        CloseHandle(mapping);
+      this->data = static_cast<const unsigned char*>(view);
+      this->open = view != nullptr;
+    }
+  }
+  CloseHandle(file);
+#else
+  const int file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (file < 0)
+    return;
+  struct stat info {};
+  if (fstat(file, &info) == 0) {
+    this->size = static_cast<std::size_t>(info.st_size);
+    this->open = true;
+    // an empty file can't be mapped, but it is a valid empty view
+    if (this->size > 0) {
+      void* view = mmap(nullptr, this->size, PROT_READ, MAP_PRIVATE, file, 0);
+      this->data = view == MAP_FAILED ? nullptr
+                                      : static_cast<const unsigned char*>(view);
+      this->open = this->data != nullptr;
+    }
+  }
+  // the mapping stays valid after the descriptor is closed
+  ::close(file);
+#endif
+  if (!this->open)
+    this->size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+  this->close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr))
+    , size(std::exchange(other.size, 0))
+    , open(std::exchange(other.open, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if (this != &other) {
+    this->close();
+    this->data = std::exchange(other.data, nullptr);
+    this->size = std::exchange(other.size, 0);
+    this->open = std::exchange(other.open, false);
+  }
+  return *this;
+}
+
+void MappedFile::close()
+{
+  if (this->data != nullptr) {
+#if defined(_WIN32)
+    UnmapViewOfFile(this->data);
+#else
+    munmap(const_cast<unsigned char*>(this->data), this->size);
+#endif
+  }
+  this->data = nullptr;
+  this->size = 0;
+  this->open = false;
+}
@@ -0,0 +1,46 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// A read-only view of a whole file mapped into memory. Pages are read from
+// disk (or the page cache) when first touched, so opening a large file is
+// cheap and only the parts that are used cost anything.
+class MappedFile
+{
+public:
+  MappedFile() = default;
+  // Maps the file; IsOpen() tells whether that worked
+  explicit MappedFile(const std::filesystem::path& path);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& other) noexcept;
+  MappedFile& operator=(MappedFile&& other) noexcept;
+
+  // false if the file couldn't be opened or mapped; an empty file is open
+  bool IsOpen() const { return open; }
+  const unsigned char* Data() const { return data; }
+  std::size_t Size() const { return size; }
+  std::span<const unsigned char> Bytes() const { return {data, size}; }
+
+private:
+  void close();
+
+  const unsigned char* data = nullptr;
+  std::size_t size = 0;
+  bool open = false;
+};
+
+#endif
@@ -8,57 +8,63 @@
 ******************************************************************/
 #include "particle_generator.h"
 
+namespace
+{
+// Per-instance attributes: position x/y and color r/g/b/a
+constexpr unsigned int instanceStreams = 6;
+}  // namespace
+
 ParticleGenerator::ParticleGenerator(Shader shader,
-                                     Texture2D texture,
-                                     unsigned int amount)
-    : shader(shader)
+                                     TextureRegion texture,
+                                     unsigned int amount,
+                                     std::uint64_t seed)
+    : particles(amount)
+    , random(seed, RandomStream::Particles)
+    , shader(shader)
     , texture(texture)
-    , amount(amount)
 {
   this->init();
 }
 
 void ParticleGenerator::Update(float dt,
-                               GameObject& object,
+                               const GameObject& object,
                                unsigned int newParticles,
                                glm::vec2 offset)
 {
   // add new particles
-  for (unsigned int i = 0; i < newParticles; ++i) {
-    int unusedParticle = this->firstUnusedParticle();
-    this->respawnParticle(this->particles[unusedParticle], object, offset);
-  }
+  for (unsigned int i = 0; i < newParticles; ++i)
+    this->respawnParticle(object, offset);
   // update all particles
-  for (unsigned int i = 0; i < this->amount; ++i) {
-    Particle& p = this->particles[i];
-    p.Life -= dt;  // reduce life
-    if (p.Life > 0.0f) {  // particle is alive, thus update
-      p.Position -= p.Velocity * dt;
-      p.Color.a -= dt * 2.5f;
-    }
-  }
+  this->particles.Update(dt);
 }
 
 // render all particles
 void ParticleGenerator::Draw()
 {
+  this->stats = Stats {this->particles.Size(), 0};
+  if (this->particles.Size() == 0)
+    return;
+  this->upload();
   // use additive blending to give it a 'glow' effect
   glBlendFunc(GL_SRC_ALPHA, GL_ONE);
   this->shader.Use();
-  for (Particle particle : this->particles) {
-    if (particle.Life > 0.0f) {
-      this->shader.SetVector2f("offset", particle.Position);
-      this->shader.SetVector4f("color", particle.Color);
-      this->texture.Bind();
-      glBindVertexArray(this->VAO);
-      glDrawArrays(GL_TRIANGLES, 0, 6);
-      glBindVertexArray(0);
-    }
-  }
+  this->shader.Set(this->texRectUniform, this->texture.Rect);
+  this->texture.Texture->Bind();
+  glBindVertexArray(this->VAO);
+  glDrawArraysInstanced(
+      GL_TRIANGLES, 0, 6, static_cast<GLsizei>(this->particles.Size()));
+  glBindVertexArray(0);
+  ++this->stats.DrawCalls;
   // don't forget to reset to default blending mode
   glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
+void ParticleGenerator::SetShader(Shader program)
+{
+  this->shader = program;
+  this->texRectUniform = this->shader.Uniform<glm::vec4>("texRect");
+}
+
 void ParticleGenerator::init()
 {
   // TODO: Use GL_TRIANGLE_STRIP instead
@@ -78,49 +84,64 @@ void ParticleGenerator::init()
   // set mesh attributes
   glEnableVertexAttribArray(0);
   glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), (void*)0);
-  glBindVertexArray(0);
 
-  // TODO: Use vector resize instead
-  // create this->amount default particle instances
-  for (unsigned int i = 0; i < this->amount; ++i)
-    this->particles.push_back(Particle());
+  // the instance buffer mirrors the particle streams back to back:
+  // <x...> <y...> <r...> <g...> <b...> <a...>, Capacity() floats each
+  const auto region = this->particles.Capacity() * sizeof(float);
+  glGenBuffers(1, &this->instanceVBO);
+  glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(instanceStreams * region),
+               nullptr,
+               GL_STREAM_DRAW);
+  for (GLuint i = 0; i < instanceStreams; ++i) {
+    const GLuint location = i + 1;
+    glEnableVertexAttribArray(location);
+    glVertexAttribPointer(location,
+                          1,
+                          GL_FLOAT,
+                          GL_FALSE,
+                          sizeof(float),
+                          reinterpret_cast<const void*>(i * region));
+    glVertexAttribDivisor(location, 1);
+  }
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+  this->texRectUniform = this->shader.Uniform<glm::vec4>("texRect");
 }
 
-// TODO: Remove global variable
-// stores the index of the last particle used (for quick access to next dead
-// particle)
-unsigned int lastUsedParticle = 0;
-unsigned int ParticleGenerator::firstUnusedParticle()
+void ParticleGenerator::upload()
 {
-  // first search from last used particle, this will usually return almost
-  // instantly
-  for (unsigned int i = lastUsedParticle; i < this->amount; ++i) {
-    if (this->particles[i].Life <= 0.0f) {
-      lastUsedParticle = i;
-      return i;
-    }
-  }
-  // otherwise, do a linear search
-  for (unsigned int i = 0; i < lastUsedParticle; ++i) {
-    if (this->particles[i].Life <= 0.0f) {
-      lastUsedParticle = i;
-      return i;
-    }
-  }
-  // all particles are taken, override the first one (note that if it repeatedly
-  // hits this case, more particles should be reserved)
-  lastUsedParticle = 0;
-  return 0;
+  const float* streams[instanceStreams] = {this->particles.PositionsX(),
+                                           this->particles.PositionsY(),
+                                           this->particles.ColorsR(),
+                                           this->particles.ColorsG(),
+                                           this->particles.ColorsB(),
+                                           this->particles.ColorsA()};
+  const auto region = this->particles.Capacity() * sizeof(float);
+  const auto used = this->particles.Size() * sizeof(float);
+  glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+  // orphan last frame's storage so the driver doesn't stall on draws that
+  // still read from it
+  glBufferData(GL_ARRAY_BUFFER,
+               static_cast<GLsizeiptr>(instanceStreams * region),
+               nullptr,
+               GL_STREAM_DRAW);
+  for (unsigned int i = 0; i < instanceStreams; ++i)
+    glBufferSubData(GL_ARRAY_BUFFER,
+                    static_cast<GLintptr>(i * region),
+                    static_cast<GLsizeiptr>(used),
+                    streams[i]);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
-void ParticleGenerator::respawnParticle(Particle& particle,
-                                        GameObject& object,
+void ParticleGenerator::respawnParticle(const GameObject& object,
                                         glm::vec2 offset)
 {
-  float random = ((rand() % 100) - 50) / 10.0f;
-  float rColor = 0.5f + ((rand() % 100) / 100.0f);
-  particle.Position = object.Position + random + offset;
-  particle.Color = glm::vec4(rColor, rColor, rColor, 1.0f);
-  particle.Life = 1.0f;
-  particle.Velocity = object.Velocity * 0.1f;
+  const float spread = this->random.Range(-5.0f, 5.0f);
+  const float rColor = this->random.Range(0.5f, 1.5f);
+  this->particles.Spawn(object.Position + spread + offset,
+                        object.Velocity * 0.1f,
+                        glm::vec4(rColor, rColor, rColor, 1.0f),
+                        1.0f);
 }
@@ -9,30 +9,15 @@
 #ifndef PARTICLE_GENERATOR_H
 #define PARTICLE_GENERATOR_H
 #include "game_object.h"
+#include "particle_system.h"
+#include "random.h"
 #include "shader.h"
 #include "texture.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include <vector>
-
-// TODO: Convert to an aggregate type
-// Represents a single particle and its state
-struct Particle
-{
-  glm::vec2 Position, Velocity;
-  glm::vec4 Color;
-  float Life;
-
-  Particle()
-      : Position(0.0f)
-      , Velocity(0.0f)
-      , Color(1.0f)
-      , Life(0.0f)
-  {
-  }
-};
+#include <cstdint>
 
 // ParticleGenerator acts as a container for rendering a large number of
 // particles by repeatedly spawning and updating particles and killing
@@ -40,41 +25,57 @@ struct Particle
 class ParticleGenerator
 {
 public:
+  // Counters of the last Draw()
+  struct Stats
+  {
+    unsigned int Particles = 0;
+    unsigned int DrawCalls = 0;
+  };
+
   // Constructor
   ParticleGenerator() = default;
-  ParticleGenerator(Shader shader, Texture2D texture, unsigned int amount);
+  ParticleGenerator(Shader shader,
+                    TextureRegion texture,
+                    unsigned int amount,
+                    std::uint64_t seed = 0);
 
   // Update all particles
   void Update(float dt,
-              GameObject& object,
+              const GameObject& object,
               unsigned int newParticles,
               glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 
-  // Render all particles
+  // Render all particles with a single instanced draw call
   void Draw();
 
+  // Draws with another shader or texture from now on, e.g. a reloaded one
+  void SetShader(Shader program);
+  void SetTexture(TextureRegion region) { this->texture = region; }
+
+  const Stats& GetStats() const { return stats; }
+
 private:
-  // Initializes buffer and vertex attributes
+  // Initializes buffers and vertex attributes
   void init();
+  // Streams the live particles into the instance buffer
+  void upload();
 
-  // Returns the first Particle index that's currently unused e.g. Life <= 0.0f
-  // or 0 if no particle is currently inactive
-  unsigned int firstUnusedParticle();
-
-  // Respawns particle
-  void respawnParticle(Particle& particle,
-                       GameObject& object,
+  // Spawns a particle at the given object
+  void respawnParticle(const GameObject& object,
                        glm::vec2 offset = glm::vec2(0.0f, 0.0f));
 
   // Data
   // State
-  std::vector<Particle> particles {};
-  unsigned int amount {};
+  ParticleSystem particles {};
+  Random random {0, RandomStream::Particles};
 
   // Render state
   Shader shader {};
-  Texture2D texture {};
+  TextureRegion texture {};
+  UniformHandle<glm::vec4> texRectUniform {};
   unsigned int VAO {};
+  unsigned int instanceVBO {};
+  Stats stats {};
 };
 
 #endif
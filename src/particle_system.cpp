@@ -0,0 +1,302 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "particle_system.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#  define BREAKOUT_PARTICLES_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#  endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#  define BREAKOUT_PARTICLES_NEON 1
+#  include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit AVX2 instructions in functions that ask for them;
+// MSVC accepts the intrinsics anywhere
+#if defined(BREAKOUT_PARTICLES_X86) \
+    && (defined(__GNUC__) || defined(__clang__))
+#  define BREAKOUT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#  define BREAKOUT_TARGET_AVX2
+#endif
+
+namespace
+{
+// Number of floats in the widest supported vector
+constexpr unsigned int maxLanes = 8;
+// Rate at which particles fade out, in alpha per second
+constexpr float fadeRate = 2.5f;
+
+// Streams a kernel reads and writes
+struct Streams
+{
+  float* positionX;
+  float* positionY;
+  const float* velocityX;
+  const float* velocityY;
+  float* alpha;
+  float* life;
+};
+
+// All kernels compute the same thing: age the particle, move it against its
+// velocity (particles trail behind the object that emits them) and fade it
+void updateScalar(const Streams& s, unsigned int count, float dt)
+{
+  const float fade = dt * fadeRate;
+  for (unsigned int i = 0; i < count; ++i) {
+    s.life[i] -= dt;
+    s.positionX[i] -= s.velocityX[i] * dt;
+    s.positionY[i] -= s.velocityY[i] * dt;
+    s.alpha[i] -= fade;
+  }
+}
+
+#if defined(BREAKOUT_PARTICLES_X86)
+// count is rounded up to whole vectors; the streams are padded for that
+void updateSSE2(const Streams& s, unsigned int count, float dt)
+{
+  const __m128 step = _mm_set1_ps(dt);
+  const __m128 fade = _mm_set1_ps(dt * fadeRate);
+  for (unsigned int i = 0; i < count; i += 4) {
+    const __m128 vx = _mm_loadu_ps(s.velocityX + i);
+    const __m128 vy = _mm_loadu_ps(s.velocityY + i);
+    _mm_storeu_ps(s.life + i, _mm_sub_ps(_mm_loadu_ps(s.life + i), step));
+    _mm_storeu_ps(s.positionX + i,
+                  _mm_sub_ps(_mm_loadu_ps(s.positionX + i),
+                             _mm_mul_ps(vx, step)));
+    _mm_storeu_ps(s.positionY + i,
+                  _mm_sub_ps(_mm_loadu_ps(s.positionY + i),
+                             _mm_mul_ps(vy, step)));
+    _mm_storeu_ps(s.alpha + i, _mm_sub_ps(_mm_loadu_ps(s.alpha + i), fade));
+  }
+}
+
+BREAKOUT_TARGET_AVX2
+void updateAVX2(const Streams& s, unsigned int count, float dt)
+{
+  const __m256 step = _mm256_set1_ps(dt);
+  const __m256 fade = _mm256_set1_ps(dt * fadeRate);
+  for (unsigned int i = 0; i < count; i += 8) {
+    const __m256 vx = _mm256_loadu_ps(s.velocityX + i);
+    const __m256 vy = _mm256_loadu_ps(s.velocityY + i);
+    _mm256_storeu_ps(s.life + i,
+                     _mm256_sub_ps(_mm256_loadu_ps(s.life + i), step));
+    _mm256_storeu_ps(s.positionX + i,
+                     _mm256_sub_ps(_mm256_loadu_ps(s.positionX + i),
+                                   _mm256_mul_ps(vx, step)));
+    _mm256_storeu_ps(s.positionY + i,
+                     _mm256_sub_ps(_mm256_loadu_ps(s.positionY + i),
+                                   _mm256_mul_ps(vy, step)));
+    _mm256_storeu_ps(s.alpha + i,
+                     _mm256_sub_ps(_mm256_loadu_ps(s.alpha + i), fade));
+  }
+}
+
+bool cpuHasAVX2()
+{
+#  if defined(__GNUC__) || defined(__clang__)
+  return __builtin_cpu_supports("avx2") != 0;
+#  elif defined(_MSC_VER)
+  // the CPU has to support AVX2 and the OS has to save the YMM registers
+  int info[4];
+  __cpuid(info, 1);
+  const bool osSavesYmm = (info[2] & (1 << 27)) != 0
+      && (_xgetbv(0) & 0x6) == 0x6;
+  __cpuidex(info, 7, 0);
+  return osSavesYmm && (info[1] & (1 << 5)) != 0;
+#  else
+  return false;
+#  endif
+}
+#endif
+
+#if defined(BREAKOUT_PARTICLES_NEON)
+void updateNEON(const Streams& s, unsigned int count, float dt)
+{
+  const float32x4_t step = vdupq_n_f32(dt);
+  const float32x4_t fade = vdupq_n_f32(dt * fadeRate);
+  for (unsigned int i = 0; i < count; i += 4) {
+    vst1q_f32(s.life + i, vsubq_f32(vld1q_f32(s.life + i), step));
+    vst1q_f32(s.positionX + i,
+              vmlsq_f32(vld1q_f32(s.positionX + i),
+                        vld1q_f32(s.velocityX + i),
+                        step));
+    vst1q_f32(s.positionY + i,
+              vmlsq_f32(vld1q_f32(s.positionY + i),
+                        vld1q_f32(s.velocityY + i),
+                        step));
+    vst1q_f32(s.alpha + i, vsubq_f32(vld1q_f32(s.alpha + i), fade));
+  }
+}
+#endif
+
+unsigned int roundUp(unsigned int count, unsigned int lanes)
+{
+  return (count + lanes - 1) / lanes * lanes;
+}
+}  // namespace
+
+ParticleSystem::ParticleSystem(unsigned int maxParticles)
+    : capacity(maxParticles)
+    , kernel(BestKernel())
+{
+  const unsigned int padded = roundUp(maxParticles, maxLanes);
+  for (std::vector<float>* stream : {&this->positionX,
+                                     &this->positionY,
+                                     &this->velocityX,
+                                     &this->velocityY,
+                                     &this->colorR,
+                                     &this->colorG,
+                                     &this->colorB,
+                                     &this->colorA,
+                                     &this->life})
+    stream->resize(padded, 0.0f);
+}
+
+void ParticleSystem::Spawn(glm::vec2 position,
+                           glm::vec2 velocity,
+                           glm::vec4 color,
+                           float lifetime)
+{
+  if (this->capacity == 0)
+    return;
+  unsigned int slot = this->size;
+  if (this->size < this->capacity) {
+    ++this->size;
+  } else {
+    // all particles are taken, replace one (if this happens repeatedly, more
+    // particles should be reserved)
+    slot = this->overwrite;
+    this->overwrite = (this->overwrite + 1) % this->capacity;
+  }
+  this->positionX[slot] = position.x;
+  this->positionY[slot] = position.y;
+  this->velocityX[slot] = velocity.x;
+  this->velocityY[slot] = velocity.y;
+  this->colorR[slot] = color.r;
+  this->colorG[slot] = color.g;
+  this->colorB[slot] = color.b;
+  this->colorA[slot] = color.a;
+  this->life[slot] = lifetime;
+}
+
+void ParticleSystem::Update(float dt)
+{
+  const Streams streams {this->positionX.data(),
+                         this->positionY.data(),
+                         this->velocityX.data(),
+                         this->velocityY.data(),
+                         this->colorA.data(),
+                         this->life.data()};
+  switch (this->kernel) {
+#if defined(BREAKOUT_PARTICLES_X86)
+    case Kernel::SSE2:
+      updateSSE2(streams, roundUp(this->size, 4), dt);
+      break;
+    case Kernel::AVX2:
+      updateAVX2(streams, roundUp(this->size, 8), dt);
+      break;
+#endif
+#if defined(BREAKOUT_PARTICLES_NEON)
+    case Kernel::NEON:
+      updateNEON(streams, roundUp(this->size, 4), dt);
+      break;
+#endif
+    default:
+      updateScalar(streams, this->size, dt);
+      break;
+  }
+  this->removeDead();
+}
+
+void ParticleSystem::removeDead()
+{
+  unsigned int i = 0;
+  while (i < this->size) {
+    if (this->life[i] > 0.0f) {
+      ++i;
+      continue;
+    }
+    // fill the hole with the last particle, which still has to be checked
+    --this->size;
+    this->move(this->size, i);
+  }
+  if (this->overwrite >= this->size)
+    this->overwrite = 0;
+}
+
+void ParticleSystem::move(unsigned int from, unsigned int to)
+{
+  this->positionX[to] = this->positionX[from];
+  this->positionY[to] = this->positionY[from];
+  this->velocityX[to] = this->velocityX[from];
+  this->velocityY[to] = this->velocityY[from];
+  this->colorR[to] = this->colorR[from];
+  this->colorG[to] = this->colorG[from];
+  this->colorB[to] = this->colorB[from];
+  this->colorA[to] = this->colorA[from];
+  this->life[to] = this->life[from];
+}
+
+void ParticleSystem::SetKernel(Kernel requested)
+{
+  this->kernel = IsSupported(requested) ? requested : BestKernel();
+}
+
+ParticleSystem::Kernel ParticleSystem::BestKernel()
+{
+  if (IsSupported(Kernel::AVX2))
+    return Kernel::AVX2;
+  if (IsSupported(Kernel::SSE2))
+    return Kernel::SSE2;
+  if (IsSupported(Kernel::NEON))
+    return Kernel::NEON;
+  return Kernel::Scalar;
+}
+
+bool ParticleSystem::IsSupported(Kernel candidate)
+{
+  switch (candidate) {
+    case Kernel::Scalar:
+      return true;
+#if defined(BREAKOUT_PARTICLES_X86)
+    case Kernel::SSE2:
+      // part of the x86-64 baseline
+      return true;
+    case Kernel::AVX2: {
+      static const bool supported = cpuHasAVX2();
+      return supported;
+    }
+#endif
+#if defined(BREAKOUT_PARTICLES_NEON)
+    case Kernel::NEON:
+      // part of the AArch64 baseline
+      return true;
+#endif
+    default:
+      return false;
+  }
+}
+
+const char* ParticleSystem::KernelName(Kernel value)
+{
+  switch (value) {
+    case Kernel::Scalar:
+      return "scalar";
+    case Kernel::SSE2:
+      return "SSE2";
+    case Kernel::AVX2:
+      return "AVX2";
+    case Kernel::NEON:
+      return "NEON";
+  }
+  return "unknown";
+}
@@ -0,0 +1,98 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef PARTICLE_SYSTEM_H
+#define PARTICLE_SYSTEM_H
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// ParticleSystem stores particles as a structure of arrays: every attribute
+// lives in its own contiguous stream and the live particles always occupy
+// the dense range [0, Size()). Spawning appends at the end, dying particles
+// are swap-removed, so neither has to search for a free slot. The per-frame
+// integration runs on the widest SIMD instruction set the CPU supports.
+class ParticleSystem
+{
+public:
+  // Implementations of the update kernel
+  enum class Kernel
+  {
+    Scalar,
+    SSE2,
+    AVX2,
+    NEON
+  };
+
+  // Constructor
+  ParticleSystem() = default;
+  explicit ParticleSystem(unsigned int maxParticles);
+
+  // Adds a particle; when the pool is full, live particles are overwritten
+  // round-robin
+  void Spawn(glm::vec2 position,
+             glm::vec2 velocity,
+             glm::vec4 color,
+             float lifetime);
+  // Ages and moves all particles by dt seconds and removes the dead ones
+  void Update(float dt);
+  // Kills all particles
+  void Clear() { size = 0; }
+
+  unsigned int Size() const { return size; }
+  unsigned int Capacity() const { return capacity; }
+
+  // Attribute streams of the live particles, Size() elements each
+  const float* PositionsX() const { return positionX.data(); }
+  const float* PositionsY() const { return positionY.data(); }
+  const float* ColorsR() const { return colorR.data(); }
+  const float* ColorsG() const { return colorG.data(); }
+  const float* ColorsB() const { return colorB.data(); }
+  const float* ColorsA() const { return colorA.data(); }
+  const float* Lives() const { return life.data(); }
+
+  glm::vec2 Position(unsigned int i) const
+  {
+    return {positionX[i], positionY[i]};
+  }
+  glm::vec4 Color(unsigned int i) const
+  {
+    return {colorR[i], colorG[i], colorB[i], colorA[i]};
+  }
+
+  // Selects the update kernel; unsupported kernels fall back to the best
+  // available one
+  void SetKernel(Kernel requested);
+  Kernel GetKernel() const { return kernel; }
+
+  // Widest kernel supported by the compiler and the running CPU
+  static Kernel BestKernel();
+  static bool IsSupported(Kernel candidate);
+  static const char* KernelName(Kernel value);
+
+private:
+  // Moves the particle at index from into slot to
+  void move(unsigned int from, unsigned int to);
+  void removeDead();
+
+  // Streams are padded to a multiple of the widest vector so kernels never
+  // need a scalar tail
+  std::vector<float> positionX, positionY;
+  std::vector<float> velocityX, velocityY;
+  std::vector<float> colorR, colorG, colorB, colorA;
+  std::vector<float> life;
+
+  unsigned int size {};
+  unsigned int capacity {};
+  // next slot to overwrite when spawning into a full pool
+  unsigned int overwrite {};
+  Kernel kernel = Kernel::Scalar;
+};
+
+#endif
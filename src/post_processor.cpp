@@ -59,7 +59,22 @@ PostProcessor::PostProcessor(Shader shader,
   glBindFramebuffer(GL_FRAMEBUFFER, 0);
   // initialize render data and uniforms
   this->initRenderData();
+  this->initUniforms();
+}
+
+void PostProcessor::SetShader(Shader shader)
+{
+  this->PostProcessingShader = shader;
+  this->initUniforms();
+}
+
+void PostProcessor::initUniforms()
+{
   this->PostProcessingShader.SetInteger("scene", 0, true);
+  this->timeUniform = this->PostProcessingShader.Uniform<float>("time");
+  this->confuseUniform = this->PostProcessingShader.Uniform<int>("confuse");
+  this->chaosUniform = this->PostProcessingShader.Uniform<int>("chaos");
+  this->shakeUniform = this->PostProcessingShader.Uniform<int>("shake");
   float offset = 1.0f / 300.0f;
   float offsets[9][2] = {
       {-offset, offset},  // top-left
@@ -126,10 +141,10 @@ void PostProcessor::Render(float time)
 {
   // set uniforms/options
   this->PostProcessingShader.Use();
-  this->PostProcessingShader.SetFloat("time", time);
-  this->PostProcessingShader.SetInteger("confuse", this->Confuse);
-  this->PostProcessingShader.SetInteger("chaos", this->Chaos);
-  this->PostProcessingShader.SetInteger("shake", this->Shake);
+  this->PostProcessingShader.Set(this->timeUniform, time);
+  this->PostProcessingShader.Set(this->confuseUniform, this->Confuse);
+  this->PostProcessingShader.Set(this->chaosUniform, this->Chaos);
+  this->PostProcessingShader.Set(this->shakeUniform, this->Shake);
   // render textured quad
   glActiveTexture(GL_TEXTURE0);
   this->Texture.Bind();
@@ -10,7 +10,6 @@
 #define POST_PROCESSOR_H
 
 #include "shader.h"
-#include "sprite_renderer.h"
 #include "texture.h"
 
 #include <glad/glad.h>
@@ -39,6 +38,8 @@ public:
   // Renders the PostProcessor texture quad (as a screen-encompassing large
   // sprite)
   void Render(float time);
+  // Renders with another shader from now on, e.g. a reloaded one
+  void SetShader(Shader shader);
 
   // State
   Shader PostProcessingShader;
@@ -51,6 +52,12 @@ public:
 private:
   // Initialize quad for rendering postprocessing texture
   void initRenderData();
+  // Sets the uniforms that never change and resolves the others
+  void initUniforms();
+
+  // Uniforms updated every frame
+  UniformHandle<float> timeUniform;
+  UniformHandle<int> confuseUniform, chaosUniform, shakeUniform;
 
   // Render state
   unsigned int MSFBO, FBO;  // MSFBO = Multisampled FBO. FBO is regular, used
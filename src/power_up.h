@@ -9,41 +9,143 @@
 #ifndef POWER_UP_H
 #define POWER_UP_H
 #include "game_object.h"
+#include "resource_registry.h"
 
-#include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include <string>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
 
 // The size of a PowerUp block
 const glm::vec2 POWERUP_SIZE(60.0f, 20.0f);
 // Velocity a PowerUp block has when spawned
 const glm::vec2 VELOCITY(0.0f, 150.0f);
 
-// PowerUp inherits its state and rendering functions from
-// GameObject but also holds extra information to state its
-// active duration and whether it is activated or not.
-// The type of PowerUp is stored as a string.
+// The kinds of power-ups, in the order their chances are rolled
+enum class PowerUpType : std::uint8_t
+{
+  Speed,
+  Sticky,
+  PassThrough,
+  PadSizeIncrease,
+  Confuse,
+  Chaos
+};
+
+constexpr std::size_t POWERUP_TYPE_COUNT = 6;
+
+// What sets a kind of power-up apart, besides its effect
+struct PowerUpInfo
+{
+  // the sprite renderers draw it with
+  ResourceId Texture;
+  glm::vec3 Color;
+  // seconds the effect lasts once the power-up was picked up; 0 for effects
+  // that stay until the player loses the ball
+  float Duration;
+  // a destroyed brick spawns the power-up with a chance of 1 in Chance
+  unsigned int Chance;
+};
+
+// The power-up kinds, indexed by PowerUpType
+inline const std::array<PowerUpInfo, POWERUP_TYPE_COUNT> POWERUP_INFO {{
+    {"powerup_speed"_id, glm::vec3(0.5f, 0.5f, 1.0f), 0.0f, 75},
+    {"powerup_sticky"_id, glm::vec3(1.0f, 0.5f, 1.0f), 20.0f, 75},
+    {"powerup_passthrough"_id, glm::vec3(0.5f, 1.0f, 0.5f), 10.0f, 75},
+    {"powerup_increase"_id, glm::vec3(1.0f, 0.6f, 0.4f), 0.0f, 75},
+    // negative power-ups spawn more often
+    {"powerup_confuse"_id, glm::vec3(1.0f, 0.3f, 0.3f), 15.0f, 15},
+    {"powerup_chaos"_id, glm::vec3(0.9f, 0.25f, 0.25f), 15.0f, 15},
+}};
+
+inline const PowerUpInfo& GetPowerUpInfo(PowerUpType type)
+{
+  return POWERUP_INFO[static_cast<std::size_t>(type)];
+}
+
+// PowerUp inherits its state from GameObject but also holds extra
+// information to state its active duration and whether it is activated or
+// not.
 class PowerUp : public GameObject
 {
 public:
-  // TODO: Use enum instead of string?
   // powerup state
-  std::string Type;
-  float Duration;
-  bool Activated;
-  // constructor
-  PowerUp(std::string type,
-          glm::vec3 color,
-          float duration,
-          glm::vec2 position,
-          Texture2D texture)
-      : GameObject(position, POWERUP_SIZE, texture, color, VELOCITY)
+  PowerUpType Type = PowerUpType::Speed;
+  float Duration = 0.0f;
+  bool Activated = false;
+  // constructors
+  PowerUp() = default;
+  PowerUp(PowerUpType type, glm::vec2 position)
+      : GameObject(position, POWERUP_SIZE, GetPowerUpInfo(type).Color, VELOCITY)
       , Type(type)
-      , Duration(duration)
-      , Activated()
+      , Duration(GetPowerUpInfo(type).Duration)
   {
   }
 };
 
+// PowerUpPool keeps the power-ups of a game in a fixed number of slots. A
+// power-up keeps its slot from spawning until it is removed, so spawning
+// and removing never allocate; a power-up spawned while all slots are taken
+// is dropped.
+class PowerUpPool
+{
+public:
+  static constexpr std::size_t Capacity = 64;
+
+  // the new power-up's slot, or Capacity if the pool is full
+  std::size_t Spawn(PowerUpType type, glm::vec2 position)
+  {
+    const auto slot = static_cast<std::size_t>(std::countr_one(this->used));
+    if (slot == Capacity)
+      return Capacity;
+    this->used |= bit(slot);
+    this->slots[slot] = PowerUp(type, position);
+    this->serials[slot] = ++this->spawned;
+    return slot;
+  }
+  void Remove(std::size_t slot) { this->used &= ~bit(slot); }
+  void Clear() { this->used = 0; }
+
+  bool IsUsed(std::size_t slot) const { return (this->used & bit(slot)) != 0; }
+  std::size_t Size() const
+  {
+    return static_cast<std::size_t>(std::popcount(this->used));
+  }
+  PowerUp& operator[](std::size_t slot) { return slots[slot]; }
+  const PowerUp& operator[](std::size_t slot) const { return slots[slot]; }
+  // tells apart the power-ups that used a slot one after the other
+  std::uint32_t Serial(std::size_t slot) const { return serials[slot]; }
+
+  // calls fn(slot, powerUp) for every power-up, in slot order
+  template<typename Fn>
+  void ForEach(Fn&& fn)
+  {
+    for (std::uint64_t left = this->used; left != 0; left &= left - 1) {
+      const auto slot = static_cast<std::size_t>(std::countr_zero(left));
+      fn(slot, this->slots[slot]);
+    }
+  }
+  template<typename Fn>
+  void ForEach(Fn&& fn) const
+  {
+    for (std::uint64_t left = this->used; left != 0; left &= left - 1) {
+      const auto slot = static_cast<std::size_t>(std::countr_zero(left));
+      fn(slot, this->slots[slot]);
+    }
+  }
+
+private:
+  static constexpr std::uint64_t bit(std::size_t slot)
+  {
+    return std::uint64_t {1} << slot;
+  }
+
+  std::array<PowerUp, Capacity> slots {};
+  std::array<std::uint32_t, Capacity> serials {};
+  std::uint64_t used = 0;
+  std::uint32_t spawned = 0;
+};
+
 #endif
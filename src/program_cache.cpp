@@ -0,0 +1,114 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "program_cache.h"
+
+#include "hash.h"
+#include "mapped_file.h"
+
+#include <cstring>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Bump whenever the cache file layout changes
+constexpr std::uint32_t formatVersion = 1;
+constexpr char magic[8] = {'B', 'K', 'P', 'R', 'O', 'G', 'R', 'M'};
+
+struct FileHeader
+{
+  char Magic[8];
+  std::uint32_t Version;
+  std::uint32_t Format;
+  std::uint64_t Key;
+  std::uint64_t Size;
+};
+
+std::string_view glString(GLenum name)
+{
+  const GLubyte* value = glGetString(name);
+  return value == nullptr ? std::string_view {}
+                          : reinterpret_cast<const char*>(value);
+}
+}  // namespace
+
+std::string DriverIdentity()
+{
+  std::string identity;
+  for (std::string_view part :
+       {glString(GL_VENDOR), glString(GL_RENDERER), glString(GL_VERSION)})
+  {
+    identity += part;
+    identity += '\n';
+  }
+  return identity;
+}
+
+std::uint64_t ProgramBinaryKey(std::string_view driver,
+                               std::initializer_list<std::string_view> sources)
+{
+  std::uint64_t hash = MixBits(formatVersion);
+  hash = HashBytes(driver.data(), driver.size(), hash);
+  // hashing the lengths too keeps ("ab", "c") and ("a", "bc") apart
+  for (std::string_view source : sources)
+    hash = HashBytes(source.data(), source.size(), hash + source.size());
+  return hash;
+}
+
+bool SaveProgramBinary(const ProgramBinary& binary,
+                       std::uint64_t key,
+                       const fs::path& path)
+{
+  std::error_code error;
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path(), error);
+  // write next to the target and rename, so a crash never leaves a
+  // half-written cache behind
+  fs::path temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    FileHeader header {};
+    std::memcpy(header.Magic, magic, sizeof(magic));
+    header.Version = formatVersion;
+    header.Format = binary.Format;
+    header.Key = key;
+    header.Size = binary.Data.size();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(binary.Data.data()),
+              static_cast<std::streamsize>(binary.Data.size()));
+    if (!out)
+      return false;
+  }
+  fs::rename(temporary, path, error);
+  return !error;
+}
+
+std::optional<ProgramBinary> LoadProgramBinary(std::uint64_t key,
+                                               const fs::path& path)
+{
+  const MappedFile file(path);
+  FileHeader header {};
+  if (!file.IsOpen() || file.Size() < sizeof(header))
+    return std::nullopt;
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.Magic, magic, sizeof(magic)) != 0
+      || header.Version != formatVersion || header.Key != key
+      || header.Size != file.Size() - sizeof(header))
+    return std::nullopt;
+  ProgramBinary binary;
+  binary.Format = header.Format;
+  binary.Data.assign(file.Data() + sizeof(header),
+                     file.Data() + file.Size());
+  return binary;
+}
@@ -0,0 +1,38 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include "shader.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+
+// Names the driver of the current GL context: its vendor, renderer and
+// version strings. A program binary is only valid for the driver it came from.
+std::string DriverIdentity();
+
+// Identifies a program linked from the given stage sources by the driver
+std::uint64_t ProgramBinaryKey(std::string_view driver,
+                               std::initializer_list<std::string_view> sources);
+
+// Writes a program binary to a cache file; false on failure
+bool SaveProgramBinary(const ProgramBinary& binary,
+                       std::uint64_t key,
+                       const std::filesystem::path& path);
+// Reads a program binary back; nothing if the file is missing, damaged or was
+// saved under another key
+std::optional<ProgramBinary> LoadProgramBinary(
+    std::uint64_t key, const std::filesystem::path& path);
+
+#endif
@@ -0,0 +1,77 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#include <cstdint>
+
+// Streams of one seed for the subsystems that draw random numbers, so one of
+// them drawing more or fewer numbers never changes what another one gets
+namespace RandomStream
+{
+constexpr std::uint64_t Gameplay = 0;
+constexpr std::uint64_t Particles = 1;
+}  // namespace RandomStream
+
+// Random is a PCG32 generator (https://www.pcg-random.org): 64 bits of
+// state, one multiply per number and 2^63 independent streams per seed.
+// Unlike rand() every user owns its generator, so threads don't contend for
+// it, and a seed gives the same numbers on every platform.
+class Random
+{
+public:
+  explicit Random(std::uint64_t seed = 0, std::uint64_t stream = 0)
+      : increment(stream << 1u | 1u)
+  {
+    this->Next();
+    this->state += seed;
+    this->Next();
+  }
+
+  // uniformly distributed over all 32-bit values
+  std::uint32_t Next()
+  {
+    const std::uint64_t old = this->state;
+    this->state = old * 6364136223846793005ULL + this->increment;
+    const auto xorShifted =
+        static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+    const auto rotation = static_cast<std::uint32_t>(old >> 59u);
+    return xorShifted >> rotation | xorShifted << (-rotation & 31u);
+  }
+
+  // uniformly distributed in [0, bound), for bound > 0; multiplies instead
+  // of dividing and only retries on the rare biased draws (Lemire's method)
+  std::uint32_t Below(std::uint32_t bound)
+  {
+    std::uint64_t product = std::uint64_t {this->Next()} * bound;
+    auto low = static_cast<std::uint32_t>(product);
+    if (low < bound) {
+      const std::uint32_t threshold = -bound % bound;
+      while (low < threshold) {
+        product = std::uint64_t {this->Next()} * bound;
+        low = static_cast<std::uint32_t>(product);
+      }
+    }
+    return static_cast<std::uint32_t>(product >> 32u);
+  }
+
+  // uniformly distributed in [0, 1)
+  float NextFloat()
+  {
+    return static_cast<float>(this->Next() >> 8u) * (1.0f / 16777216.0f);
+  }
+  // uniformly distributed in [lo, hi)
+  float Range(float lo, float hi) { return lo + (hi - lo) * this->NextFloat(); }
+
+private:
+  std::uint64_t state = 0;
+  std::uint64_t increment;
+};
+
+#endif
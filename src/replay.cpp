@@ -0,0 +1,316 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "replay.h"
+
+#include "hash.h"
+#include "mapped_file.h"
+
+#include <cstring>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Bump whenever the file layout changes
+constexpr std::uint32_t formatVersion = 1;
+constexpr char magic[8] = {'B', 'K', 'R', 'E', 'P', 'L', 'A', 'Y'};
+// Encoded bytes collected before they are handed to the writer thread
+constexpr std::size_t chunkSize = 4096;
+
+struct FileHeader
+{
+  char Magic[8];
+  std::uint32_t Version;
+  std::uint32_t Width;
+  std::uint32_t Height;
+  float TickSeconds;
+  std::uint64_t Seed;
+  std::uint32_t Level;
+  std::uint32_t HardMode;
+};
+
+struct FileFooter
+{
+  std::uint64_t Ticks;
+  std::uint64_t FinalState;
+};
+
+// Hashes a value with no padding bytes into hash
+template<typename T>
+std::uint64_t mix(std::uint64_t hash, const T& value)
+{
+  return HashBytes(&value, sizeof(value), hash);
+}
+
+// Reads a variable-length integer at pos, moving pos past it; false if the
+// data ends first or the number doesn't fit
+bool readVarint(const unsigned char*& pos,
+                const unsigned char* end,
+                std::uint64_t& value)
+{
+  value = 0;
+  for (unsigned int shift = 0; shift < 64; shift += 7) {
+    if (pos == end)
+      return false;
+    const unsigned char byte = *pos++;
+    value |= std::uint64_t {byte & 0x7fu} << shift;
+    if ((byte & 0x80u) == 0)
+      return true;
+  }
+  return false;
+}
+}  // namespace
+
+std::uint64_t HashState(const Simulation& sim)
+{
+  std::uint64_t hash = mix(0, sim.State);
+  hash = mix(hash, sim.Level);
+  hash = mix(hash, sim.Lives);
+  hash = mix(hash, sim.IsHardModeOn());
+  hash = mix(hash, sim.Player.Position);
+  hash = mix(hash, sim.Player.Size);
+  hash = mix(hash, sim.Ball.Position);
+  hash = mix(hash, sim.Ball.Velocity);
+  hash = mix(hash, sim.Ball.Stuck);
+  hash = mix(hash, sim.Ball.Sticky);
+  hash = mix(hash, sim.Ball.PassThrough);
+  hash = mix(hash, sim.Ball.Color);
+  hash = mix(hash, sim.Effects.Confuse);
+  hash = mix(hash, sim.Effects.Chaos);
+  hash = mix(hash, sim.Effects.Shake);
+  if (sim.Level < sim.Levels.size()) {
+    const auto words = sim.Levels[sim.Level].AliveBricks().Words();
+    hash = HashBytes(words.data(), words.size_bytes(), hash);
+  }
+  sim.PowerUps.ForEach(
+      [&hash](std::size_t slot, const PowerUp& powerUp)
+      {
+        hash = mix(hash, slot);
+        hash = mix(hash, powerUp.Type);
+        hash = mix(hash, powerUp.Position);
+        hash = mix(hash, powerUp.Duration);
+        hash = mix(hash, powerUp.Activated);
+      });
+  return hash;
+}
+
+ReplayRecorder::ReplayRecorder(const fs::path& file,
+                               const Simulation& sim,
+                               float tickSeconds)
+    : path(file)
+    , temporary(file)
+{
+  // written next to the target and renamed when finished, so a recording
+  // that was cut short never looks like a complete one
+  this->temporary += ".tmp";
+  this->out.open(this->temporary, std::ios::binary | std::ios::trunc);
+  this->open = static_cast<bool>(this->out);
+  if (!this->open)
+    return;
+
+  FileHeader header {};
+  std::memcpy(header.Magic, magic, sizeof(magic));
+  header.Version = formatVersion;
+  header.Width = sim.Width;
+  header.Height = sim.Height;
+  header.TickSeconds = tickSeconds;
+  header.Seed = sim.GetSeed();
+  header.Level = sim.Level;
+  header.HardMode = sim.IsHardModeOn() ? 1 : 0;
+  this->buffer.reserve(chunkSize + 64);
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&header);
+  this->buffer.assign(bytes, bytes + sizeof(header));
+  this->writer = std::thread(&ReplayRecorder::write, this);
+}
+
+ReplayRecorder::~ReplayRecorder()
+{
+  if (!this->open || this->finished)
+    return;
+  // without the final state the recording is of no use
+  {
+    std::lock_guard lock(this->mutex);
+    this->closing = true;
+  }
+  this->chunkQueued.notify_one();
+  this->writer.join();
+  this->out.close();
+  std::error_code error;
+  fs::remove(this->temporary, error);
+}
+
+void ReplayRecorder::RecordTick(std::span<const KeyEvent> events)
+{
+  if (!this->open || this->finished)
+    return;
+  ++this->ticks;
+  std::size_t count = 0;
+  for (const KeyEvent& event : events)
+    if (Controls::IsBound(event.Key))
+      ++count;
+  if (count == 0)
+    return;
+  // ticks start at 1, so the gap is never 0, which marks the end
+  this->writeVarint(this->ticks - this->lastRecorded);
+  this->lastRecorded = this->ticks;
+  this->writeVarint(count);
+  for (const KeyEvent& event : events)
+    if (Controls::IsBound(event.Key))
+      this->writeVarint(static_cast<std::uint64_t>(event.Key) << 1
+                        | (event.Pressed ? 1u : 0u));
+  if (this->buffer.size() >= chunkSize)
+    this->flush();
+}
+
+bool ReplayRecorder::Finish(const Simulation& sim)
+{
+  if (!this->open || this->finished)
+    return false;
+  this->finished = true;
+  this->writeVarint(0);
+  FileFooter footer {this->ticks, HashState(sim)};
+  const auto* bytes = reinterpret_cast<const unsigned char*>(&footer);
+  this->buffer.insert(this->buffer.end(), bytes, bytes + sizeof(footer));
+  this->flush();
+  {
+    std::lock_guard lock(this->mutex);
+    this->closing = true;
+  }
+  this->chunkQueued.notify_one();
+  this->writer.join();
+
+  this->out.close();
+  std::error_code error;
+  if (!this->out) {
+    fs::remove(this->temporary, error);
+    return false;
+  }
+  fs::rename(this->temporary, this->path, error);
+  return !error;
+}
+
+void ReplayRecorder::writeVarint(std::uint64_t value)
+{
+  while (value >= 0x80) {
+    this->buffer.push_back(static_cast<unsigned char>(value | 0x80));
+    value >>= 7;
+  }
+  this->buffer.push_back(static_cast<unsigned char>(value));
+}
+
+void ReplayRecorder::flush()
+{
+  if (this->buffer.empty())
+    return;
+  std::vector<unsigned char> chunk;
+  chunk.reserve(chunkSize + 64);
+  std::swap(chunk, this->buffer);
+  {
+    std::lock_guard lock(this->mutex);
+    this->chunks.push_back(std::move(chunk));
+  }
+  this->chunkQueued.notify_one();
+}
+
+void ReplayRecorder::write()
+{
+  std::vector<unsigned char> chunk;
+  while (true) {
+    {
+      std::unique_lock lock(this->mutex);
+      this->chunkQueued.wait(
+          lock, [this] { return this->closing || !this->chunks.empty(); });
+      if (this->chunks.empty())
+        return;
+      chunk = std::move(this->chunks.front());
+      this->chunks.pop_front();
+    }
+    this->out.write(reinterpret_cast<const char*>(chunk.data()),
+                    static_cast<std::streamsize>(chunk.size()));
+  }
+}
+
+std::optional<Replay> Replay::Open(const fs::path& path)
+{
+  const MappedFile file(path);
+  FileHeader header {};
+  FileFooter footer {};
+  if (!file.IsOpen() || file.Size() < sizeof(header) + 1 + sizeof(footer))
+    return std::nullopt;
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.Magic, magic, sizeof(magic)) != 0
+      || header.Version != formatVersion || !(header.TickSeconds > 0.0f))
+    return std::nullopt;
+
+  Replay replay;
+  replay.setup.Width = header.Width;
+  replay.setup.Height = header.Height;
+  replay.setup.TickSeconds = header.TickSeconds;
+  replay.setup.Seed = header.Seed;
+  replay.setup.Level = header.Level;
+  replay.setup.HardMode = header.HardMode != 0;
+
+  const unsigned char* pos = file.Data() + sizeof(header);
+  const unsigned char* const end =
+      file.Data() + file.Size() - sizeof(footer);
+  unsigned long long tick = 0;
+  while (true) {
+    std::uint64_t gap = 0;
+    if (!readVarint(pos, end, gap))
+      return std::nullopt;
+    if (gap == 0)
+      break;
+    std::uint64_t count = 0;
+    if (!readVarint(pos, end, count)
+        || count > static_cast<std::uint64_t>(end - pos))
+      return std::nullopt;
+    tick += gap;
+    replay.tickEvents.push_back(
+        {tick, replay.events.size(), static_cast<std::size_t>(count)});
+    for (std::uint64_t i = 0; i < count; ++i) {
+      std::uint64_t code = 0;
+      if (!readVarint(pos, end, code) || (code >> 1) >= 1024)
+        return std::nullopt;
+      replay.events.push_back(
+          {static_cast<int>(code >> 1), (code & 1u) != 0});
+    }
+  }
+  if (pos != end)
+    return std::nullopt;
+  std::memcpy(&footer, end, sizeof(footer));
+  if (tick > footer.Ticks)
+    return std::nullopt;
+  replay.ticks = footer.Ticks;
+  replay.finalState = footer.FinalState;
+  return replay;
+}
+
+std::uint64_t Replay::Play(Simulation& sim) const
+{
+  sim.SetSeed(this->setup.Seed);
+  if (this->setup.Level < sim.Levels.size())
+    sim.Level = this->setup.Level;
+  if (sim.IsHardModeOn() != this->setup.HardMode)
+    sim.ToggleHardMode();
+
+  Controls controls;
+  const std::span<const KeyEvent> all(this->events);
+  auto next = this->tickEvents.begin();
+  for (unsigned long long tick = 1; tick <= this->ticks; ++tick) {
+    std::span<const KeyEvent> keys;
+    if (next != this->tickEvents.end() && next->Tick == tick) {
+      keys = all.subspan(next->First, next->Count);
+      ++next;
+    }
+    sim.Step(this->setup.TickSeconds, controls.Apply(sim, keys));
+  }
+  return HashState(sim);
+}
@@ -0,0 +1,135 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include "controls.h"
+#include "simulation.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <thread>
+#include <vector>
+
+// The setup a recording starts from: everything besides the keys that
+// decides how the game plays out
+struct ReplaySetup
+{
+  unsigned int Width = 0;
+  unsigned int Height = 0;
+  float TickSeconds = 0.0f;
+  std::uint64_t Seed = 0;
+  unsigned int Level = 0;
+  bool HardMode = false;
+};
+
+// Hashes the gameplay state of sim - ball, paddle, bricks, power-ups, lives
+// and effects - bit for bit, to tell whether a replay ended where its
+// recording did
+std::uint64_t HashState(const Simulation& sim);
+
+// ReplayRecorder writes the key changes of a game to a file as it is
+// played. The file starts with the setup, followed by the ticks that had key
+// changes, each as the number of ticks since the one before and the changes
+// packed into variable-length integers, and ends with the number of ticks and
+// the hash of the final state. Encoding runs on the simulation thread, but
+// the file is written on a thread of its own, a few KiB at a time, so a slow
+// disk never holds up a tick.
+class ReplayRecorder
+{
+public:
+  // Starts recording sim, which must be in the menu and not have been
+  // stepped yet, to file; IsOpen() tells whether it could be created
+  ReplayRecorder(const std::filesystem::path& file,
+                 const Simulation& sim,
+                 float tickSeconds);
+  // Discards the recording if Finish() wasn't called
+  ~ReplayRecorder();
+
+  ReplayRecorder(const ReplayRecorder&) = delete;
+  ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+  bool IsOpen() const { return open; }
+  // Records the key changes applied in the next tick; call once per tick,
+  // with or without changes
+  void RecordTick(std::span<const KeyEvent> events);
+  // Ends the recording with the state of sim after the last tick and waits
+  // for the file to be written; false if it couldn't be
+  bool Finish(const Simulation& sim);
+  unsigned long long Ticks() const { return ticks; }
+
+private:
+  void writeVarint(std::uint64_t value);
+  // hands the encoded bytes to the writer thread
+  void flush();
+  void write();
+
+  std::filesystem::path path;
+  std::filesystem::path temporary;
+  std::ofstream out;
+  bool open = false;
+  bool finished = false;
+  unsigned long long ticks = 0;
+  unsigned long long lastRecorded = 0;
+  std::vector<unsigned char> buffer;
+
+  std::thread writer;
+  std::mutex mutex;
+  std::condition_variable chunkQueued;
+  // guarded by mutex
+  std::deque<std::vector<unsigned char>> chunks;
+  bool closing = false;
+};
+
+// A recording read back into memory
+class Replay
+{
+public:
+  // Reads a recording; nothing if it isn't a replay of this format version
+  // or is cut short
+  static std::optional<Replay> Open(const std::filesystem::path& path);
+
+  const ReplaySetup& Setup() const { return setup; }
+  unsigned long long Ticks() const { return ticks; }
+  std::uint64_t FinalState() const { return finalState; }
+  // Key changes recorded in total
+  std::size_t EventCount() const { return events.size(); }
+
+  // Plays the recording on sim, which must have been created with the
+  // setup's size and initialized with the levels the recording was made
+  // with, and not have been stepped yet. Returns the hash of the state it
+  // ends in, which is FinalState() if the replay re-simulated the game
+  // exactly.
+  std::uint64_t Play(Simulation& sim) const;
+
+private:
+  // The key changes of one tick
+  struct TickEvents
+  {
+    unsigned long long Tick = 0;
+    std::size_t First = 0;
+    std::size_t Count = 0;
+  };
+
+  Replay() = default;
+
+  ReplaySetup setup;
+  unsigned long long ticks = 0;
+  std::uint64_t finalState = 0;
+  std::vector<KeyEvent> events;
+  std::vector<TickEvents> tickEvents;
+};
+
+#endif
@@ -0,0 +1,89 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "replay.h"
+#include "simulation.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// Plays recordings made with the game's --record option headless, as fast as
+// the simulation runs, and checks that each ends in the state it was
+// recorded in:
+//
+//   Breakout_replay <replay> [--levels=<dir>] [--repeat=<n>]
+//
+// Every run prints the ticks simulated per second, the best of --repeat runs
+// (1 by default); the levels are read from --levels (levels by default) and
+// must be the ones the recording was made with. Exits with 1 if a replay
+// doesn't match its recording, so recordings can be kept as regression and
+// performance tests.
+int main(int argc, char* argv[])
+{
+  std::filesystem::path file;
+  std::filesystem::path levels = "levels";
+  unsigned int repeat = 1;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg.starts_with("--levels=")) {
+      levels = arg.substr(9);
+    } else if (arg.starts_with("--repeat=") && std::atoi(argv[i] + 9) > 0) {
+      repeat = static_cast<unsigned int>(std::atoi(argv[i] + 9));
+    } else if (file.empty() && !arg.starts_with("--")) {
+      file = arg;
+    } else {
+      file.clear();
+      break;
+    }
+  }
+  if (file.empty()) {
+    std::cerr << "Usage: " << argv[0]
+              << " <replay> [--levels=<dir>] [--repeat=<n>]\n";
+    return 2;
+  }
+
+  const auto replay = Replay::Open(file);
+  if (!replay) {
+    std::cerr << "Could not read " << file.string() << '\n';
+    return 1;
+  }
+  const ReplaySetup& setup = replay->Setup();
+  const double seconds = static_cast<double>(replay->Ticks())
+      * static_cast<double>(setup.TickSeconds);
+  std::cout << file.string() << ": " << replay->Ticks() << " ticks ("
+            << seconds << " s), " << replay->EventCount()
+            << " key changes, seed " << setup.Seed << '\n';
+
+  double best = 0.0;
+  for (unsigned int run = 0; run < repeat; ++run) {
+    Simulation sim(setup.Width, setup.Height);
+    sim.Init(levels);
+    const auto start = std::chrono::steady_clock::now();
+    const std::uint64_t state = replay->Play(sim);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    if (state != replay->FinalState()) {
+      std::cerr << file.string()
+                << ": the replay diverged from the recording\n";
+      return 1;
+    }
+    const double rate =
+        static_cast<double>(replay->Ticks()) / std::max(elapsed.count(), 1e-9);
+    std::cout << "run " << run + 1 << ": " << elapsed.count() * 1000.0
+              << " ms, " << rate << " ticks/s\n";
+    best = std::max(best, rate);
+  }
+  if (repeat > 1)
+    std::cout << "best: " << best << " ticks/s\n";
+  return 0;
+}
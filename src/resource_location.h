@@ -17,8 +17,24 @@ static const std::string textureDirectory = "textures";
  * @param filename The name of the texture file.
  * @return The path of the texture relative to the main executable.
  */
-fs::path PathToTexture(const std::string& filename)
+inline fs::path PathToTexture(const std::string& filename)
 {
   return fs::path(textureDirectory) / filename;
 }
+
+/**
+ * @brief The location of files generated from resources, such as glyph
+ * atlases, to skip generating them on later runs. It can be deleted any time.
+ */
+static const std::string cacheDirectory = "cache";
+
+/**
+ * @brief Returns the path to a cache file.
+ * @param filename The name of the cache file.
+ * @return The path of the cache file relative to the main executable.
+ */
+inline fs::path PathToCache(const std::string& filename)
+{
+  return fs::path(cacheDirectory) / filename;
+}
 }  // namespace Location
\ No newline at end of file
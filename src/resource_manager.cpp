@@ -8,22 +8,439 @@
 ******************************************************************/
 #include "resource_manager.h"
 
+#include "asset_loader.h"
+#include "program_cache.h"
 #include "resource_location.h"
+#include "texture_atlas.h"
+#include "texture_cache.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include <stb_image.h>
-
+#include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <format>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <optional>
 #include <sstream>
 
 namespace fs = std::filesystem;
 
 // Instantiate static variables
-std::map<std::string, Texture2D> ResourceManager::Textures;
-std::map<std::string, Shader> ResourceManager::Shaders;
+ResourceRegistry<Texture2D> ResourceManager::Textures;
+ResourceRegistry<Shader> ResourceManager::Shaders;
+ResourceRegistry<TextureRegion> ResourceManager::Regions;
+
+namespace
+{
+// An atlas packed in memory or read from the cache, ready to be uploaded
+struct AtlasPixels
+{
+  AtlasLayout Layout;
+  CookedTexture Pixels;
+};
+
+// The source code of the stages of a shader program
+struct ShaderSources
+{
+  std::string Vertex;
+  std::string Fragment;
+  std::optional<std::string> Geometry;
+};
+
+// How a resource is loaded again when one of its files changes
+struct Reloadable
+{
+  std::vector<fs::path> Files;
+  std::function<AssetHandle(AssetLoader&)> Reload;
+};
+
+// The resources loaded so far, under their kind and name
+ResourceRegistry<Reloadable> reloadables;
+
+// The form in which the files of resources are compared
+fs::path normalPath(const fs::path& file)
+{
+  return fs::absolute(file).lexically_normal();
+}
+
+void rememberFiles(const std::string& key,
+                   std::vector<fs::path> files,
+                   std::function<AssetHandle(AssetLoader&)> reload)
+{
+  for (fs::path& file : files)
+    file = normalPath(file);
+  reloadables.Set(key, Reloadable {std::move(files), std::move(reload)});
+}
+
+void requireFile(const fs::path& filepath)
+{
+  if (!fs::exists(filepath)) {
+    throw fs::filesystem_error {
+        std::format("Texture not found: {}", filepath.string()), filepath, {}};
+  }
+}
+
+// The file a texture is cooked into
+fs::path cookedPath(const std::string& name)
+{
+  return Location::PathToCache(std::format("textures/{}.tex", name));
+}
+
+void saveCooked(const CookedTexture& texture,
+                std::uint64_t key,
+                const fs::path& cacheFile)
+{
+  if (!SaveCookedTexture(texture, key, cacheFile))
+    std::cout << "WARNING::TEXTURE: Could not cache texture in "
+              << cacheFile.string() << std::endl;
+}
+
+/**
+ * @brief Reads the texture cooked from an image file by an earlier run, or
+ * decodes and cooks it.
+ *
+ * Cooked textures are RGBA with all their mipmaps, mapped from the cache
+ * without decoding. They are cooked again when the image file changes.
+ *
+ * @param filepath  The path to the image.
+ * @return The pixels of the texture.
+ */
+CookedTexture cookTexture(const fs::path& filepath)
+{
+  requireFile(filepath);
+  const std::uint64_t key = CookedTextureKey({filepath});
+  const fs::path cacheFile = cookedPath(filepath.filename().string());
+  if (auto cooked = LoadCookedTexture(key, cacheFile))
+    return std::move(*cooked);
+  auto decoded = DecodeTexture(filepath);
+  if (!decoded) {
+    throw std::runtime_error {
+        std::format("Failed to load texture {}", filepath.string())};
+  }
+  decoded->GenerateMipmaps();
+  saveCooked(*decoded, key, cacheFile);
+  return std::move(*decoded);
+}
+
+// Packs the images of an atlas into the smallest power of two rectangle up
+// to maxSize pixels wide and high; the packed pixels are cooked like a
+// texture
+AtlasPixels packAtlas(const std::vector<AtlasImage>& images,
+                      const std::string& atlasName,
+                      unsigned int maxSize)
+{
+  // the layout only depends on the image sizes, which the file headers tell
+  std::vector<fs::path> files;
+  std::vector<AtlasRect> sizes;
+  for (const AtlasImage& image : images) {
+    files.push_back(Location::PathToTexture(image.File));
+    requireFile(files.back());
+    const auto size = ReadTextureSize(files.back());
+    if (!size) {
+      throw std::runtime_error {
+          std::format("Failed to load texture {}", files.back().string())};
+    }
+    sizes.push_back(*size);
+  }
+
+  constexpr unsigned int padding = 1;
+  auto layout = PackAtlas(sizes, padding, maxSize);
+  if (!layout) {
+    throw std::runtime_error {
+        std::format("Images of atlas \"{}\" don't fit into {}x{} pixels",
+                    atlasName,
+                    maxSize,
+                    maxSize)};
+  }
+  // the images and the packer's limits determine the pixels
+  const std::uint64_t key =
+      CookedTextureKey(files, std::uint64_t {maxSize} << 32 | padding);
+  const fs::path cacheFile = cookedPath(atlasName);
+  auto cooked = LoadCookedTexture(key, cacheFile);
+  if (cooked && cooked->Width() == layout->Width
+      && cooked->Height() == layout->Height)
+    return AtlasPixels {std::move(*layout), std::move(*cooked)};
+
+  std::vector<unsigned char> pixels(
+      std::size_t {layout->Width} * layout->Height * 4, 0);
+  for (std::size_t i = 0; i < files.size(); ++i) {
+    const auto decoded = DecodeTexture(files[i]);
+    if (!decoded) {
+      throw std::runtime_error {
+          std::format("Failed to load texture {}", files[i].string())};
+    }
+    CopyIntoAtlas(
+        pixels, layout->Width, decoded->Pixels(), layout->Rects[i], padding);
+  }
+  // no mipmaps: at smaller levels the one pixel borders no longer keep the
+  // images apart
+  AtlasPixels atlas {std::move(*layout), {}};
+  atlas.Pixels =
+      CookedTexture(std::move(pixels), atlas.Layout.Width, atlas.Layout.Height);
+  saveCooked(atlas.Pixels, key, cacheFile);
+  return atlas;
+}
+
+// The largest texture the GL implementation supports
+unsigned int maxTextureSize()
+{
+  GLint maxSize = 0;
+  glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+  return static_cast<unsigned int>(maxSize);
+}
+
+std::string readFile(const char* path)
+{
+  std::ifstream file(path);
+  std::stringstream stream;
+  stream << file.rdbuf();
+  return stream.str();
+}
+
+ShaderSources readShaderSources(const char* vShaderFile,
+                                const char* fShaderFile,
+                                const char* gShaderFile)
+{
+  // TODO: Check if file exists
+  ShaderSources sources;
+  try {
+    sources.Vertex = readFile(vShaderFile);
+    sources.Fragment = readFile(fShaderFile);
+    // if geometry shader path is present, also load a geometry shader
+    if (gShaderFile != nullptr)
+      sources.Geometry = readFile(gShaderFile);
+  } catch (std::exception e) {
+    std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
+  }
+  return sources;
+}
+
+/**
+ * @brief Creates a shader program from its sources.
+ *
+ * Linked programs are cached as driver binaries, so a program is only
+ * compiled again when its sources or the driver change, or when the driver
+ * rejects the binary.
+ *
+ * @param sources  The source code of the stages.
+ * @param name     The name the program is stored under.
+ * @return The linked program.
+ */
+Shader compileShader(const ShaderSources& sources, const std::string& name)
+{
+  Shader shader;
+  const bool cached = Shader::BinariesSupported();
+  const std::uint64_t key = cached
+      ? ProgramBinaryKey(
+            DriverIdentity(),
+            {sources.Vertex, sources.Fragment, sources.Geometry.value_or("")})
+      : 0;
+  const fs::path cacheFile =
+      Location::PathToCache(std::format("shaders/{}.bin", name));
+  if (cached) {
+    const auto binary = LoadProgramBinary(key, cacheFile);
+    if (binary && shader.LoadBinary(*binary))
+      return shader;
+  }
+  shader.Compile(sources.Vertex.c_str(),
+                 sources.Fragment.c_str(),
+                 sources.Geometry ? sources.Geometry->c_str() : nullptr);
+  if (cached) {
+    const auto binary = shader.GetBinary();
+    if (binary && !SaveProgramBinary(*binary, key, cacheFile))
+      std::cout << "WARNING::SHADER: Could not cache program in "
+                << cacheFile.string() << std::endl;
+  }
+  return shader;
+}
+
+std::string textureName(const std::string& file,
+                        const std::string& resourceName)
+{
+  return resourceName.empty() ? fs::path(file).stem().string() : resourceName;
+}
+
+Texture2D& storeTexture(const std::string& name, const Texture2D& texture)
+{
+  auto handle = ResourceManager::Textures.Add(name, texture);
+  if (!handle.IsValid()) {
+    throw std::runtime_error {
+        std::format("A texture with name \"{}\" already exists", name)};
+  }
+  return ResourceManager::Textures[handle];
+}
+
+// A stored texture to load again
+Texture2D& storedTexture(const std::string& name)
+{
+  Texture2D* texture = ResourceManager::Textures.TryGet(ResourceId::Of(name));
+  if (texture == nullptr) {
+    throw std::runtime_error {
+        std::format("Texture with name \"{}\" does not exist", name)};
+  }
+  return *texture;
+}
+
+// Uploads the pixels and mipmaps of a cooked texture into texture
+void fillTexture(Texture2D& texture, const CookedTexture& pixels)
+{
+  const auto& levels = pixels.Levels();
+  if (levels.size() > 1)
+    texture.Filter_Min = GL_LINEAR_MIPMAP_LINEAR;
+  texture.Generate(pixels.Width(), pixels.Height(), pixels.Pixels());
+  for (std::size_t i = 1; i < levels.size(); ++i)
+    texture.AddMipmap(static_cast<unsigned int>(i),
+                      levels[i].Width,
+                      levels[i].Height,
+                      pixels.Pixels(i));
+}
+
+Texture2D& uploadTexture(const CookedTexture& pixels,
+                         bool alpha,
+                         const std::string& name)
+{
+  // create texture object; cooked pixels are always RGBA, the texture drops
+  // the alpha channel if it isn't used
+  Texture2D texture;
+  texture.Internal_Format = alpha ? GL_RGBA : GL_RGB;
+  texture.Image_Format = GL_RGBA;
+  fillTexture(texture, pixels);
+  Texture2D& stored = storeTexture(name, texture);
+  ResourceManager::Regions.Set(name, TextureRegion(stored));
+  return stored;
+}
+
+// Stores the region of each image of an atlas; when reloading, regions that
+// exist are replaced
+void storeRegions(const Texture2D& atlas,
+                  const AtlasLayout& layout,
+                  const std::vector<AtlasImage>& images,
+                  bool reload)
+{
+  const auto atlasWidth = static_cast<float>(layout.Width);
+  const auto atlasHeight = static_cast<float>(layout.Height);
+  for (std::size_t i = 0; i < images.size(); ++i) {
+    const AtlasRect& rect = layout.Rects[i];
+    const std::string name =
+        textureName(images[i].File, images[i].ResourceName);
+    const glm::vec4 uv(static_cast<float>(rect.X) / atlasWidth,
+                       static_cast<float>(rect.Y) / atlasHeight,
+                       static_cast<float>(rect.Width) / atlasWidth,
+                       static_cast<float>(rect.Height) / atlasHeight);
+    const TextureRegion region(atlas, uv);
+    if (reload) {
+      ResourceManager::Regions.Set(name, region);
+    } else if (!ResourceManager::Regions.Add(name, region).IsValid()) {
+      throw std::runtime_error {
+          std::format("A texture with name \"{}\" already exists", name)};
+    }
+  }
+}
+
+Texture2D& uploadAtlas(const AtlasPixels& atlas,
+                       const std::vector<AtlasImage>& images,
+                       const std::string& atlasName)
+{
+  const AtlasLayout& layout = atlas.Layout;
+  Texture2D texture;
+  texture.Internal_Format = GL_RGBA;
+  texture.Image_Format = GL_RGBA;
+  texture.Wrap_S = GL_CLAMP_TO_EDGE;
+  texture.Wrap_T = GL_CLAMP_TO_EDGE;
+  texture.Generate(layout.Width, layout.Height, atlas.Pixels.Pixels());
+  Texture2D& stored = storeTexture(atlasName, texture);
+  storeRegions(stored, layout, images, false);
+  return stored;
+}
+
+// Replaces a stored shader with a program built from changed sources; a
+// program that failed to build is dropped and the old one kept
+void replaceShader(const std::string& name, const Shader& shader)
+{
+  if (!shader.IsLinked()) {
+    glDeleteProgram(shader.ID);
+    throw std::runtime_error {std::format(
+        "Shader \"{}\" failed to build, keeping the old program", name)};
+  }
+  if (const Shader* old = ResourceManager::Shaders.TryGet(ResourceId::Of(name)))
+    glDeleteProgram(old->ID);
+  ResourceManager::Shaders.Set(name, shader);
+}
+
+// Remembers the files of a shader to read and compile it again when one of
+// them changes
+void rememberShader(const std::string& vertex,
+                    const std::string& fragment,
+                    const std::optional<std::string>& geometry,
+                    const std::string& name)
+{
+  std::vector<fs::path> files {vertex, fragment};
+  if (geometry)
+    files.emplace_back(*geometry);
+  rememberFiles(
+      "shader/" + name,
+      std::move(files),
+      [vertex, fragment, geometry, name](AssetLoader& loader)
+      {
+        return loader.Load(
+            name,
+            [vertex, fragment, geometry]
+            {
+              return readShaderSources(vertex.c_str(),
+                                       fragment.c_str(),
+                                       geometry ? geometry->c_str() : nullptr);
+            },
+            [name](ShaderSources sources)
+            { replaceShader(name, compileShader(sources, name)); });
+      });
+}
+
+// Remembers the file of a texture to cook and upload it again, into the same
+// texture object, when it changes
+void rememberTexture(const fs::path& filepath, const std::string& name)
+{
+  rememberFiles("texture/" + name,
+                {filepath},
+                [filepath, name](AssetLoader& loader)
+                {
+                  return loader.Load(
+                      name,
+                      [filepath] { return cookTexture(filepath); },
+                      [name](CookedTexture pixels)
+                      { fillTexture(storedTexture(name), pixels); });
+                });
+}
+
+// Remembers the images of an atlas to pack and upload it again, into the
+// same texture object, when one of them changes
+void rememberAtlas(const std::vector<AtlasImage>& images,
+                   const std::string& atlasName,
+                   unsigned int maxSize)
+{
+  std::vector<fs::path> files;
+  for (const AtlasImage& image : images)
+    files.push_back(Location::PathToTexture(image.File));
+  rememberFiles(
+      "texture/" + atlasName,
+      std::move(files),
+      [images, atlasName, maxSize](AssetLoader& loader)
+      {
+        return loader.Load(
+            atlasName,
+            [images, atlasName, maxSize]
+            { return packAtlas(images, atlasName, maxSize); },
+            [images, atlasName](AtlasPixels atlas)
+            {
+              const AtlasLayout& layout = atlas.Layout;
+              Texture2D& texture = storedTexture(atlasName);
+              texture.Generate(
+                  layout.Width, layout.Height, atlas.Pixels.Pixels());
+              storeRegions(texture, layout, images, true);
+            });
+      });
+}
+}  // namespace
 
 // loads (and generates) a shader program from file loading vertex, fragment
 // (and geometry) shader's source code. If gShaderFile is not nullptr, it also
@@ -33,21 +450,64 @@ Shader& ResourceManager::LoadShader(const char* vShaderFile,
                                     const char* gShaderFile,
                                     std::string name)
 {
-  Shaders[name] = loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile);
-  return Shaders[name];
+  std::optional<std::string> geometry;
+  if (gShaderFile != nullptr)
+    geometry = gShaderFile;
+  rememberShader(vShaderFile, fShaderFile, geometry, name);
+  return Shaders[Shaders.Set(
+      name, loadShaderFromFile(vShaderFile, fShaderFile, gShaderFile, name))];
+}
+
+// reads the shader's source code on a worker; it is compiled when the loader
+// finishes it
+AssetHandle ResourceManager::LoadShaderAsync(AssetLoader& loader,
+                                             const char* vShaderFile,
+                                             const char* fShaderFile,
+                                             const char* gShaderFile,
+                                             std::string name)
+{
+  // the paths may not outlive this call
+  std::string vertex = vShaderFile;
+  std::string fragment = fShaderFile;
+  std::optional<std::string> geometry;
+  if (gShaderFile != nullptr)
+    geometry = gShaderFile;
+  rememberShader(vertex, fragment, geometry, name);
+  return loader.Load(
+      name,
+      [vertex, fragment, geometry]
+      {
+        return readShaderSources(vertex.c_str(),
+                                 fragment.c_str(),
+                                 geometry ? geometry->c_str() : nullptr);
+      },
+      [name](ShaderSources sources)
+      { Shaders.Set(name, compileShader(sources, name)); });
 }
 
 // retrieves a stored shader
-Shader& ResourceManager::GetShader(std::string name)
+Shader& ResourceManager::GetShader(ResourceId id)
+{
+  if (Shader* shader = Shaders.TryGet(id))
+    return *shader;
+  throw std::runtime_error {
+      std::format("Shader with id {:#x} does not exist", id.Hash)};
+}
+
+Shader& ResourceManager::GetShader(std::string_view name)
 {
-  return Shaders[name];
+  if (Shader* shader = Shaders.TryGet(ResourceId::Of(name)))
+    return *shader;
+  throw std::runtime_error {
+      std::format("Shader with name \"{}\" does not exist", name)};
 }
 
 /**
  * @brief Loads the texture with the specified name from the textures directory.
  *
  * If a resource name is not provided, then it will default to the name of the
- * file without its extension.
+ * file without its extension. The image is decoded and cooked with its
+ * mipmaps into the cache once; later loads map the cooked pixels from there.
  *
  * @param filename      The filename of the texture to load.
  * @param alpha         true, if the texture uses the alpha channel; false,
@@ -60,116 +520,166 @@ Texture2D& ResourceManager::LoadTexture(const std::string& filename,
                                         const std::string& resourceName)
 {
   const auto filepath = Location::PathToTexture(filename);
-  if (fs::exists(filepath)) {
-    const auto name =
-        resourceName.empty() ? filepath.stem().string() : resourceName;
-    const auto texture = LoadTextureFromFile(filepath.string(), alpha);
-    auto [it, success] = Textures.insert({name, texture});
-    if (success) {
-      return it->second;
-    } else {
-      throw std::runtime_error {
-          std::format("A texture with name \"{}\" already exists", name)};
-    }
-  } else {
-    throw fs::filesystem_error {
-        std::format("Texture not found: {}", filepath.string()), filepath, {}};
-  }
+  const std::string name = textureName(filename, resourceName);
+  const CookedTexture pixels = cookTexture(filepath);
+  Texture2D& texture = uploadTexture(pixels, alpha, name);
+  rememberTexture(filepath, name);
+  return texture;
+}
+
+/**
+ * @brief Loads a texture like LoadTexture, decoding it on a worker.
+ *
+ * The texture is created and stored when the loader finishes it.
+ *
+ * @param loader        The loader to decode the image on.
+ * @param filename      The filename of the texture to load.
+ * @param alpha         true, if the texture uses the alpha channel; false,
+ *                      otherwise.
+ * @param resourceName  The name to use for the loaded resource.
+ * @return The handle of the texture, named after its resource.
+ */
+AssetHandle ResourceManager::LoadTextureAsync(AssetLoader& loader,
+                                              const std::string& filename,
+                                              bool alpha,
+                                              const std::string& resourceName)
+{
+  const auto filepath = Location::PathToTexture(filename);
+  const std::string name = textureName(filename, resourceName);
+  return loader.Load(
+      name,
+      [filepath] { return cookTexture(filepath); },
+      [alpha, name, filepath](CookedTexture pixels)
+      {
+        uploadTexture(pixels, alpha, name);
+        rememberTexture(filepath, name);
+      });
+}
+
+/**
+ * @brief Loads images from the textures directory into a single atlas.
+ *
+ * The images are packed with a skyline packer into the smallest power of two
+ * texture that holds them, each surrounded by a one pixel border of its own
+ * edge pixels so linear filtering doesn't pick up its neighbours. All images
+ * are stored as RGBA. The packed atlas is cooked into the cache, so images are
+ * only decoded again when one of them changes.
+ *
+ * @param images     The files to pack and the names to store them under.
+ * @param atlasName  The name to store the atlas texture under.
+ * @return The atlas texture.
+ */
+Texture2D& ResourceManager::LoadTextureAtlas(
+    const std::vector<AtlasImage>& images, const std::string& atlasName)
+{
+  const unsigned int maxSize = maxTextureSize();
+  const AtlasPixels atlas = packAtlas(images, atlasName, maxSize);
+  Texture2D& texture = uploadAtlas(atlas, images, atlasName);
+  rememberAtlas(images, atlasName, maxSize);
+  return texture;
+}
+
+/**
+ * @brief Loads an atlas like LoadTextureAtlas, decoding and packing the
+ * images on a worker.
+ *
+ * The atlas texture is created and its images are stored when the loader
+ * finishes it.
+ *
+ * @param loader     The loader to decode the images on.
+ * @param images     The files to pack and the names to store them under.
+ * @param atlasName  The name to store the atlas texture under.
+ * @return The handle of the atlas, named after it.
+ */
+AssetHandle ResourceManager::LoadTextureAtlasAsync(
+    AssetLoader& loader,
+    const std::vector<AtlasImage>& images,
+    const std::string& atlasName)
+{
+  // the GL may only be queried on this thread
+  const unsigned int maxSize = maxTextureSize();
+  return loader.Load(
+      atlasName,
+      [images, atlasName, maxSize]
+      { return packAtlas(images, atlasName, maxSize); },
+      [images, atlasName, maxSize](AtlasPixels atlas)
+      {
+        uploadAtlas(atlas, images, atlasName);
+        rememberAtlas(images, atlasName, maxSize);
+      });
+}
+
+/**
+ * @brief Loads the resources that were loaded from a file again, e.g. after
+ * it was edited.
+ *
+ * Files are read, decoded and cooked on the loader's workers. When the loader
+ * finishes a resource, textures and atlases are uploaded into their texture
+ * objects, so regions and copies stay valid, and shaders are replaced by a
+ * new program; users have to fetch it with GetShader again. A shader that
+ * fails to build keeps its old program and fails its handle.
+ *
+ * @param loader  The loader to read and decode the files on.
+ * @param file    The changed file.
+ * @return The handles of the resources loaded from the file; none if no
+ *         resource was.
+ */
+std::vector<AssetHandle> ResourceManager::ReloadAsync(
+    AssetLoader& loader, const std::filesystem::path& file)
+{
+  const fs::path changed = normalPath(file);
+  std::vector<AssetHandle> handles;
+  for (const Reloadable& resource : reloadables)
+    if (std::find(resource.Files.begin(), resource.Files.end(), changed)
+        != resource.Files.end())
+      handles.push_back(resource.Reload(loader));
+  return handles;
+}
+
+/**
+ * @brief Tries to get the texture with the specified id.
+ * @param id The id of the texture resource or atlas image, e.g. "block"_id.
+ * @return The texture region with the specified id.
+ */
+TextureRegion ResourceManager::GetTexture(ResourceId id)
+{
+  if (const TextureRegion* region = Regions.TryGet(id))
+    return *region;
+  throw std::runtime_error {
+      std::format("Texture with id {:#x} does not exist", id.Hash)};
 }
 
 /**
  * @brief Tries to get the texture with the specified name.
- * @param name The name of the texture resource.
- * @return The texture with the specified name.
+ * @param name The name of the texture resource or atlas image.
+ * @return The texture region with the specified name.
  */
-Texture2D& ResourceManager::GetTexture(const std::string& name)
+TextureRegion ResourceManager::GetTexture(std::string_view name)
 {
-  auto it = Textures.find(name);
-  if (it != Textures.end()) {
-    return it->second;
-  } else {
-    throw std::runtime_error {
-        std::format("Texture with name \"{}\" does not exist", name)};
-  }
+  if (const TextureRegion* region = Regions.TryGet(ResourceId::Of(name)))
+    return *region;
+  throw std::runtime_error {
+      std::format("Texture with name \"{}\" does not exist", name)};
 }
 
 void ResourceManager::Clear()
 {
   // (properly) delete all shaders
-  for (auto iter : Shaders)
-    glDeleteProgram(iter.second.ID);
+  for (const Shader& shader : Shaders)
+    glDeleteProgram(shader.ID);
   // (properly) delete all textures
-  for (auto iter : Textures)
-    glDeleteTextures(1, &iter.second.ID);
+  for (const Texture2D& texture : Textures)
+    glDeleteTextures(1, &texture.ID);
 }
 
-Shader& ResourceManager::loadShaderFromFile(const char* vShaderFile,
-                                            const char* fShaderFile,
-                                            const char* gShaderFile)
+Shader ResourceManager::loadShaderFromFile(const char* vShaderFile,
+                                           const char* fShaderFile,
+                                           const char* gShaderFile,
+                                           const std::string& name)
 {
-  // TODO: Check if file exists
   // 1. retrieve the vertex/fragment source code from filePath
-  std::string vertexCode;
-  std::string fragmentCode;
-  std::string geometryCode;
-  try {
-    // open files
-    std::ifstream vertexShaderFile(vShaderFile);
-    std::ifstream fragmentShaderFile(fShaderFile);
-    std::stringstream vShaderStream, fShaderStream;
-    // read file's buffer contents into streams
-    vShaderStream << vertexShaderFile.rdbuf();
-    fShaderStream << fragmentShaderFile.rdbuf();
-    // close file handlers
-    vertexShaderFile.close();
-    fragmentShaderFile.close();
-    // convert stream into string
-    vertexCode = vShaderStream.str();
-    fragmentCode = fShaderStream.str();
-    // if geometry shader path is present, also load a geometry shader
-    if (gShaderFile != nullptr) {
-      std::ifstream geometryShaderFile(gShaderFile);
-      std::stringstream gShaderStream;
-      gShaderStream << geometryShaderFile.rdbuf();
-      geometryShaderFile.close();
-      geometryCode = gShaderStream.str();
-    }
-  } catch (std::exception e) {
-    std::cout << "ERROR::SHADER: Failed to read shader files" << std::endl;
-  }
-  const char* vShaderCode = vertexCode.c_str();
-  const char* fShaderCode = fragmentCode.c_str();
-  const char* gShaderCode = geometryCode.c_str();
+  const ShaderSources sources =
+      readShaderSources(vShaderFile, fShaderFile, gShaderFile);
   // 2. now create shader object from source code
-  Shader shader;
-  shader.Compile(
-      vShaderCode, fShaderCode, gShaderFile != nullptr ? gShaderCode : nullptr);
-  return shader;
-}
-
-/**
- * @brief Creates a texture object from the specified file.
- * @param filepath  The path to the source file.
- * @param alpha     true, if the texture uses the alpha channel; false,
- *                  otherwise.
- * @return The created texture object.
- */
-Texture2D ResourceManager::LoadTextureFromFile(const std::string& filepath,
-                                               bool alpha)
-{
-  // create texture object
-  Texture2D texture;
-  if (alpha) {
-    texture.Internal_Format = GL_RGBA;
-    texture.Image_Format = GL_RGBA;
-  }
-  // load image
-  int width, height, nrChannels;
-  unsigned char* data =
-      stbi_load(filepath.c_str(), &width, &height, &nrChannels, 0);
-  // now generate texture
-  texture.Generate(width, height, data);
-  // and finally free image data
-  stbi_image_free(data);
-  return texture;
+  return compileShader(sources, name);
 }
@@ -9,19 +9,32 @@
 #ifndef RESOURCE_MANAGER_H
 #define RESOURCE_MANAGER_H
 
+#include "asset_loader.h"
+#include "resource_registry.h"
 #include "shader.h"
 #include "texture.h"
 
 #include <glad/glad.h>
 
-#include <map>
+#include <filesystem>
 #include <string>
+#include <string_view>
+#include <vector>
+
+// An image to pack into a texture atlas; the resource name defaults to the
+// file name without its extension
+struct AtlasImage
+{
+  std::string File;
+  std::string ResourceName {};
+};
 
 // A static singleton ResourceManager class that hosts several
 // functions to load Textures and Shaders. Each loaded texture
-// and/or shader is also stored for future reference by string
-// handles. All functions and resources are static and no
-// public constructor is defined.
+// and/or shader is also stored for future reference by its
+// name. Lookups take the hashed id of a name, which the compiler
+// computes for names in the code ("sprite"_id). All functions
+// and resources are static and no public constructor is defined.
 class ResourceManager
 {
 public:
@@ -30,31 +43,60 @@ public:
                             const char* gShaderFile,
                             std::string name);
 
-  static Shader& GetShader(std::string name);
+  // the Load functions with an Async suffix read and decode their files on
+  // the loader's workers; the resource is created and stored when the loader
+  // finishes the returned handle
+  static AssetHandle LoadShaderAsync(AssetLoader& loader,
+                                     const char* vShaderFile,
+                                     const char* fShaderFile,
+                                     const char* gShaderFile,
+                                     std::string name);
+
+  static Shader& GetShader(ResourceId id);
+  static Shader& GetShader(std::string_view name);
 
   // loads (and generates) a texture from file
   static Texture2D& LoadTexture(const std::string& file,
                                 bool alpha,
                                 const std::string& resourceName = "");
-  // retrieves a stored texture
-  static Texture2D& GetTexture(const std::string& file);
+  static AssetHandle LoadTextureAsync(AssetLoader& loader,
+                                      const std::string& file,
+                                      bool alpha,
+                                      const std::string& resourceName = "");
+  // loads images from files and packs them into one RGBA texture stored as
+  // atlasName; each image is retrieved by its own name with GetTexture
+  static Texture2D& LoadTextureAtlas(const std::vector<AtlasImage>& images,
+                                     const std::string& atlasName);
+  static AssetHandle LoadTextureAtlasAsync(
+      AssetLoader& loader,
+      const std::vector<AtlasImage>& images,
+      const std::string& atlasName);
+  // loads the resources read from file again on the loader's workers, e.g.
+  // after the file was edited; returns their handles
+  static std::vector<AssetHandle> ReloadAsync(
+      AssetLoader& loader, const std::filesystem::path& file);
+  // retrieves a stored texture or atlas image
+  static TextureRegion GetTexture(ResourceId id);
+  static TextureRegion GetTexture(std::string_view name);
 
   // properly de-allocates all loaded resources
   static void Clear();
 
   // resource storage
-  static std::map<std::string, Shader> Shaders;
-  static std::map<std::string, Texture2D> Textures;
+  static ResourceRegistry<Shader> Shaders;
+  static ResourceRegistry<Texture2D> Textures;
+  // what GetTexture returns: the part of a texture each name refers to
+  static ResourceRegistry<TextureRegion> Regions;
 
 private:
   // private constructor, that is we do not want any actual resource manager
   // objects. Its members and functions should be publicly available (static).
   ResourceManager() {}
 
-  static Shader& loadShaderFromFile(const char* vShaderFile,
+  static Shader loadShaderFromFile(const char* vShaderFile,
                                     const char* fShaderFile,
-                                    const char* gShaderFile = nullptr);
-  static Texture2D LoadTextureFromFile(const std::string& filepath, bool alpha);
+                                    const char* gShaderFile,
+                                    const std::string& name);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,203 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef RESOURCE_REGISTRY_H
+#define RESOURCE_REGISTRY_H
+
+#include "hash.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <format>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Names a resource by a hash of its name. The ids of names written in the
+// code are computed by the compiler ("sprite"_id), so looking a resource up
+// by one hashes and allocates nothing at run time.
+struct ResourceId
+{
+  std::uint64_t Hash = 0;
+
+  // The id of a name only known at run time, e.g. read from a file
+  static constexpr ResourceId Of(std::string_view name)
+  {
+    return ResourceId {HashString(name)};
+  }
+
+  constexpr bool operator==(const ResourceId&) const = default;
+};
+
+consteval ResourceId operator""_id(const char* name, std::size_t size)
+{
+  return ResourceId::Of(std::string_view(name, size));
+}
+
+// Refers to a resource of a ResourceRegistry by its index; valid for the
+// lifetime of the registry, also when the resource is replaced
+template<typename T>
+struct ResourceHandle
+{
+  static constexpr std::uint32_t invalid = 0xffffffffu;
+
+  std::uint32_t Index = invalid;
+
+  bool IsValid() const { return Index != invalid; }
+  bool operator==(const ResourceHandle&) const = default;
+};
+
+// ResourceRegistry stores resources densely in the order they were added
+// and finds them by id through a small open-addressing index. Resources are
+// stored in chunks, so references to them stay valid as more are added.
+// Names are only kept to tell apart ids that collide.
+template<typename T>
+class ResourceRegistry
+{
+public:
+  // Stores value under name; returns an invalid handle if the name is taken
+  ResourceHandle<T> Add(std::string_view name, T value)
+  {
+    const ResourceId id = ResourceId::Of(name);
+    if (this->Find(id).IsValid()) {
+      this->checkName(id, name);
+      return ResourceHandle<T> {};
+    }
+    return this->insert(id, name, std::move(value));
+  }
+
+  // Stores value under name, replacing the resource stored under it before;
+  // handles to and references of a replaced resource stay valid
+  ResourceHandle<T> Set(std::string_view name, T value)
+  {
+    const ResourceId id = ResourceId::Of(name);
+    const ResourceHandle<T> found = this->Find(id);
+    if (!found.IsValid())
+      return this->insert(id, name, std::move(value));
+    this->checkName(id, name);
+    this->values[found.Index] = std::move(value);
+    return found;
+  }
+
+  // The handle of a resource; invalid if there is none with this id
+  ResourceHandle<T> Find(ResourceId id) const
+  {
+    if (this->slots.empty())
+      return ResourceHandle<T> {};
+    const std::size_t mask = this->slots.size() - 1;
+    for (std::size_t i = slotOf(id, mask);; i = (i + 1) & mask) {
+      const Slot& slot = this->slots[i];
+      if (slot.Index == ResourceHandle<T>::invalid || slot.Hash == id.Hash)
+        return ResourceHandle<T> {slot.Index};
+    }
+  }
+
+  // The resource behind a valid handle
+  T& operator[](ResourceHandle<T> handle) { return values[handle.Index]; }
+  const T& operator[](ResourceHandle<T> handle) const
+  {
+    return values[handle.Index];
+  }
+
+  // The resource with this id; nullptr if there is none
+  T* TryGet(ResourceId id)
+  {
+    const ResourceHandle<T> handle = this->Find(id);
+    return handle.IsValid() ? &this->values[handle.Index] : nullptr;
+  }
+  const T* TryGet(ResourceId id) const
+  {
+    const ResourceHandle<T> handle = this->Find(id);
+    return handle.IsValid() ? &this->values[handle.Index] : nullptr;
+  }
+
+  std::size_t Size() const { return values.size(); }
+  const std::string& Name(ResourceHandle<T> handle) const
+  {
+    return names[handle.Index];
+  }
+
+  // The resources in the order they were added
+  auto begin() { return values.begin(); }
+  auto end() { return values.end(); }
+  auto begin() const { return values.begin(); }
+  auto end() const { return values.end(); }
+
+  // Forgets all resources; handles and references become invalid
+  void Clear()
+  {
+    this->values.clear();
+    this->names.clear();
+    this->slots.clear();
+  }
+
+private:
+  struct Slot
+  {
+    std::uint64_t Hash = 0;
+    std::uint32_t Index = ResourceHandle<T>::invalid;
+  };
+
+  static std::size_t slotOf(ResourceId id, std::size_t mask)
+  {
+    // ids are well mixed hashes already
+    return static_cast<std::size_t>(id.Hash) & mask;
+  }
+
+  ResourceHandle<T> insert(ResourceId id, std::string_view name, T value)
+  {
+    // keep the index at most half full, so probes stay short
+    if ((this->values.size() + 1) * 2 > this->slots.size())
+      this->grow();
+    const auto index = static_cast<std::uint32_t>(this->values.size());
+    this->values.push_back(std::move(value));
+    this->names.emplace_back(name);
+    this->place(Slot {id.Hash, index});
+    return ResourceHandle<T> {index};
+  }
+
+  void place(Slot slot)
+  {
+    const std::size_t mask = this->slots.size() - 1;
+    std::size_t i = slotOf(ResourceId {slot.Hash}, mask);
+    while (this->slots[i].Index != ResourceHandle<T>::invalid)
+      i = (i + 1) & mask;
+    this->slots[i] = slot;
+  }
+
+  void grow()
+  {
+    std::vector<Slot> old =
+        std::exchange(this->slots,
+                      std::vector<Slot>(std::max<std::size_t>(
+                          16, this->slots.size() * 2)));
+    for (const Slot& slot : old)
+      if (slot.Index != ResourceHandle<T>::invalid)
+        this->place(slot);
+  }
+
+  // Two names with the same id can't both be stored
+  void checkName(ResourceId id, std::string_view name) const
+  {
+    const std::string& stored = this->names[this->Find(id).Index];
+    if (stored != name) {
+      throw std::runtime_error {std::format(
+          "Resource names \"{}\" and \"{}\" have the same id", stored, name)};
+    }
+  }
+
+  std::deque<T> values;
+  std::vector<std::string> names;
+  std::vector<Slot> slots;
+};
+
+#endif
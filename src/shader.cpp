@@ -8,6 +8,7 @@
 ******************************************************************/
 #include "shader.h"
 
+#include <cstring>
 #include <iostream>
 
 Shader& Shader::Use()
@@ -44,8 +45,13 @@ void Shader::Compile(const char* vertexSource,
   glAttachShader(this->ID, sFragment);
   if (geometrySource != nullptr)
     glAttachShader(this->ID, gShader);
+  // some drivers only keep what GetBinary needs when asked before linking
+  if (BinariesSupported())
+    glProgramParameteri(
+        this->ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
   glLinkProgram(this->ID);
   checkCompileErrors(this->ID, "PROGRAM");
+  this->cacheUniforms();
   // delete the shaders as they're linked into our program now and no longer
   // necessary
   glDeleteShader(sVertex);
@@ -54,23 +60,120 @@ void Shader::Compile(const char* vertexSource,
     glDeleteShader(gShader);
 }
 
+bool Shader::LoadBinary(const ProgramBinary& binary)
+{
+  if (!BinariesSupported())
+    return false;
+  const GLuint program = glCreateProgram();
+  glProgramBinary(program,
+                  binary.Format,
+                  binary.Data.data(),
+                  static_cast<GLsizei>(binary.Data.size()));
+  // a rejected binary is a normal outcome, not an error to report
+  GLint success = GL_FALSE;
+  glGetProgramiv(program, GL_LINK_STATUS, &success);
+  if (success != GL_TRUE) {
+    glDeleteProgram(program);
+    return false;
+  }
+  this->ID = program;
+  this->cacheUniforms();
+  return true;
+}
+
+std::optional<ProgramBinary> Shader::GetBinary() const
+{
+  if (!BinariesSupported())
+    return std::nullopt;
+  GLint length = 0;
+  glGetProgramiv(this->ID, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0)
+    return std::nullopt;
+  ProgramBinary binary;
+  binary.Data.resize(static_cast<std::size_t>(length));
+  GLsizei written = 0;
+  glGetProgramBinary(
+      this->ID, length, &written, &binary.Format, binary.Data.data());
+  if (written <= 0)
+    return std::nullopt;
+  binary.Data.resize(static_cast<std::size_t>(written));
+  return binary;
+}
+
+bool Shader::IsLinked() const
+{
+  GLint success = GL_FALSE;
+  glGetProgramiv(this->ID, GL_LINK_STATUS, &success);
+  return success == GL_TRUE;
+}
+
+bool Shader::BinariesSupported()
+{
+  // core since 4.1, which drivers hand out for the 3.3 core profile we ask
+  // for; a driver is still free to support no binary formats at all
+  if (!GLAD_GL_VERSION_4_1)
+    return false;
+  GLint formats = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+  return formats > 0;
+}
+
+void Shader::Set(UniformHandle<float> uniform, float value)
+{
+  GLint location = this->locationIfChanged(uniform.Slot, &value, sizeof(value));
+  if (location != -1)
+    glUniform1f(location, value);
+}
+void Shader::Set(UniformHandle<int> uniform, int value)
+{
+  GLint location = this->locationIfChanged(uniform.Slot, &value, sizeof(value));
+  if (location != -1)
+    glUniform1i(location, value);
+}
+void Shader::Set(UniformHandle<glm::vec2> uniform, const glm::vec2& value)
+{
+  GLint location = this->locationIfChanged(
+      uniform.Slot, glm::value_ptr(value), sizeof(value));
+  if (location != -1)
+    glUniform2f(location, value.x, value.y);
+}
+void Shader::Set(UniformHandle<glm::vec3> uniform, const glm::vec3& value)
+{
+  GLint location = this->locationIfChanged(
+      uniform.Slot, glm::value_ptr(value), sizeof(value));
+  if (location != -1)
+    glUniform3f(location, value.x, value.y, value.z);
+}
+void Shader::Set(UniformHandle<glm::vec4> uniform, const glm::vec4& value)
+{
+  GLint location = this->locationIfChanged(
+      uniform.Slot, glm::value_ptr(value), sizeof(value));
+  if (location != -1)
+    glUniform4f(location, value.x, value.y, value.z, value.w);
+}
+void Shader::Set(UniformHandle<glm::mat4> uniform, const glm::mat4& value)
+{
+  GLint location = this->locationIfChanged(
+      uniform.Slot, glm::value_ptr(value), sizeof(value));
+  if (location != -1)
+    glUniformMatrix4fv(location, 1, false, glm::value_ptr(value));
+}
+
 void Shader::SetFloat(const char* name, float value, bool useShader)
 {
   if (useShader)
     this->Use();
-  glUniform1f(glGetUniformLocation(this->ID, name), value);
+  this->Set(this->Uniform<float>(name), value);
 }
 void Shader::SetInteger(const char* name, int value, bool useShader)
 {
   if (useShader)
     this->Use();
-  glUniform1i(glGetUniformLocation(this->ID, name), value);
+  this->Set(this->Uniform<int>(name), value);
 }
 void Shader::SetVector2f(const char* name, float x, float y, bool useShader)
 {
-  if (useShader)
-    this->Use();
-  glUniform2f(glGetUniformLocation(this->ID, name), x, y);
+  this->SetVector2f(name, glm::vec2(x, y), useShader);
 }
 void Shader::SetVector2f(const char* name,
                          const glm::vec2& value,
@@ -78,14 +181,12 @@ void Shader::SetVector2f(const char* name,
 {
   if (useShader)
     this->Use();
-  glUniform2f(glGetUniformLocation(this->ID, name), value.x, value.y);
+  this->Set(this->Uniform<glm::vec2>(name), value);
 }
 void Shader::SetVector3f(
     const char* name, float x, float y, float z, bool useShader)
 {
-  if (useShader)
-    this->Use();
-  glUniform3f(glGetUniformLocation(this->ID, name), x, y, z);
+  this->SetVector3f(name, glm::vec3(x, y, z), useShader);
 }
 void Shader::SetVector3f(const char* name,
                          const glm::vec3& value,
@@ -93,14 +194,12 @@ void Shader::SetVector3f(const char* name,
 {
   if (useShader)
     this->Use();
-  glUniform3f(glGetUniformLocation(this->ID, name), value.x, value.y, value.z);
+  this->Set(this->Uniform<glm::vec3>(name), value);
 }
 void Shader::SetVector4f(
     const char* name, float x, float y, float z, float w, bool useShader)
 {
-  if (useShader)
-    this->Use();
-  glUniform4f(glGetUniformLocation(this->ID, name), x, y, z, w);
+  this->SetVector4f(name, glm::vec4(x, y, z, w), useShader);
 }
 void Shader::SetVector4f(const char* name,
                          const glm::vec4& value,
@@ -108,8 +207,7 @@ void Shader::SetVector4f(const char* name,
 {
   if (useShader)
     this->Use();
-  glUniform4f(
-      glGetUniformLocation(this->ID, name), value.x, value.y, value.z, value.w);
+  this->Set(this->Uniform<glm::vec4>(name), value);
 }
 void Shader::SetMatrix4(const char* name,
                         const glm::mat4& matrix,
@@ -117,8 +215,66 @@ void Shader::SetMatrix4(const char* name,
 {
   if (useShader)
     this->Use();
-  glUniformMatrix4fv(
-      glGetUniformLocation(this->ID, name), 1, false, glm::value_ptr(matrix));
+  this->Set(this->Uniform<glm::mat4>(name), matrix);
+}
+
+void Shader::cacheUniforms()
+{
+  auto cache = std::make_shared<std::vector<CachedUniform>>();
+  GLint count = 0;
+  GLint maxLength = 0;
+  glGetProgramiv(this->ID, GL_ACTIVE_UNIFORMS, &count);
+  glGetProgramiv(this->ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+  std::vector<char> name(static_cast<std::size_t>(maxLength) + 1);
+  for (GLint i = 0; i < count; ++i) {
+    GLsizei length = 0;
+    GLint size = 0;
+    GLenum type = 0;
+    glGetActiveUniform(this->ID,
+                       static_cast<GLuint>(i),
+                       static_cast<GLsizei>(name.size()),
+                       &length,
+                       &size,
+                       &type,
+                       name.data());
+    GLint location = glGetUniformLocation(this->ID, name.data());
+    if (location == -1)  // e.g. members of uniform blocks
+      continue;
+    CachedUniform uniform;
+    uniform.Name.assign(name.data(), static_cast<std::size_t>(length));
+    // arrays are reported as "name[0]"
+    auto bracket = uniform.Name.find('[');
+    if (bracket != std::string::npos)
+      uniform.Name.resize(bracket);
+    uniform.Location = location;
+    cache->push_back(uniform);
+  }
+  this->uniforms = std::move(cache);
+}
+
+int Shader::findUniform(const char* name) const
+{
+  if (!this->uniforms)
+    return -1;
+  // programs have a handful of uniforms; a linear scan beats hashing here and
+  // doesn't allocate
+  const auto& cache = *this->uniforms;
+  for (std::size_t i = 0; i < cache.size(); ++i)
+    if (cache[i].Name == name)
+      return static_cast<int>(i);
+  return -1;
+}
+
+GLint Shader::locationIfChanged(int slot, const void* value, std::size_t size)
+{
+  if (slot < 0 || !this->uniforms)
+    return -1;
+  CachedUniform& uniform = (*this->uniforms)[static_cast<std::size_t>(slot)];
+  if (uniform.HasValue && std::memcmp(uniform.Value.data(), value, size) == 0)
+    return -1;
+  std::memcpy(uniform.Value.data(), value, size);
+  uniform.HasValue = true;
+  return uniform.Location;
 }
 
 void Shader::checkCompileErrors(unsigned int object, std::string type)
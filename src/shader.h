@@ -13,11 +13,36 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <optional>
 #include <string>
+#include <vector>
+
+// Typed reference to an active uniform of a Shader. Resolve it once with
+// Shader::Uniform<T>() and pass it to Shader::Set() on hot paths; a default
+// constructed handle refers to no uniform and setting it is a no-op.
+template<typename T>
+struct UniformHandle
+{
+  int Slot = -1;  // index into the shader's uniform cache
+};
+
+// A linked program as serialized by the driver, see glGetProgramBinary. Only
+// the driver that produced it can load it again.
+struct ProgramBinary
+{
+  GLenum Format = 0;
+  std::vector<unsigned char> Data;
+};
 
 // General purpose shader object. Compiles from file, generates
 // compile/link-time error messages and hosts several utility
 // functions for easy management.
+// Uniform locations are resolved once after linking. The last value uploaded
+// to each uniform is remembered, so setting an unchanged value is skipped.
+// Copies of a Shader share that cache.
 class Shader
 {
 public:
@@ -32,6 +57,28 @@ public:
                const char* fragmentSource,
                const char* geometrySource =
                    nullptr);  // note: geometry source code is optional
+  // creates the program from a binary the driver handed out earlier; false if
+  // the driver rejects it, e.g. after an update, and nothing was created
+  bool LoadBinary(const ProgramBinary& binary);
+  // retrieves the linked program as a binary; nothing if the driver can't
+  std::optional<ProgramBinary> GetBinary() const;
+  // whether the program linked; a program that didn't can't be used
+  bool IsLinked() const;
+  // whether the driver can save and load program binaries at all
+  static bool BinariesSupported();
+  // looks up an active uniform; arrays are found by their plain name
+  template<typename T>
+  UniformHandle<T> Uniform(const char* name) const
+  {
+    return UniformHandle<T> {this->findUniform(name)};
+  }
+  // uploads a value through a resolved handle (expects the shader in use)
+  void Set(UniformHandle<float> uniform, float value);
+  void Set(UniformHandle<int> uniform, int value);
+  void Set(UniformHandle<glm::vec2> uniform, const glm::vec2& value);
+  void Set(UniformHandle<glm::vec3> uniform, const glm::vec3& value);
+  void Set(UniformHandle<glm::vec4> uniform, const glm::vec4& value);
+  void Set(UniformHandle<glm::mat4> uniform, const glm::mat4& value);
   // utility functions
   void SetFloat(const char* name, float value, bool useShader = false);
   void SetInteger(const char* name, int value, bool useShader = false);
@@ -58,8 +105,25 @@ public:
                   bool useShader = false);
 
 private:
+  // An active uniform and the last value uploaded to it
+  struct CachedUniform
+  {
+    std::string Name;
+    GLint Location = -1;
+    bool HasValue = false;
+    std::array<float, 16> Value {};  // large enough for a mat4
+  };
+
   // checks if compilation or linking failed and if so, print the error logs
   void checkCompileErrors(unsigned int object, std::string type);
+  // resolves the locations of all active uniforms of the linked program
+  void cacheUniforms();
+  // returns the cache slot of the named uniform or -1 if it isn't active
+  int findUniform(const char* name) const;
+  // returns the location to upload to, or -1 if value equals the last upload
+  GLint locationIfChanged(int slot, const void* value, std::size_t size);
+
+  std::shared_ptr<std::vector<CachedUniform>> uniforms;
 };
 
 #endif
\ No newline at end of file
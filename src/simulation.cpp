@@ -0,0 +1,518 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "simulation.h"
+
+#include "collision.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <utility>
+
+namespace
+{
+namespace fs = std::filesystem;
+
+bool isLevelFile(const fs::path& file)
+{
+  return file.extension() == ".lvl" || file.extension() == ".blvl";
+}
+
+// A level file without its extension, which names the level
+fs::path levelName(const fs::path& file)
+{
+  return file.lexically_normal().replace_extension();
+}
+
+// The level files in a directory, in the order they are played: sorted by
+// name, so a number in front of the name orders them. A level is loaded from
+// the binary file the build converts its text source into, or from the
+// source when there is no binary file.
+std::vector<fs::path> findLevels(const fs::path& directory)
+{
+  std::vector<fs::path> files;
+  std::error_code error;
+  for (const auto& entry : fs::directory_iterator(directory, error))
+    if (entry.is_regular_file(error) && isLevelFile(entry.path()))
+      files.push_back(entry.path());
+  auto order = [](const fs::path& file)
+  { return std::pair(levelName(file), file.extension() != ".blvl"); };
+  std::sort(files.begin(),
+            files.end(),
+            [&order](const fs::path& a, const fs::path& b)
+            { return order(a) < order(b); });
+  files.erase(std::unique(files.begin(),
+                          files.end(),
+                          [](const fs::path& a, const fs::path& b)
+                          { return levelName(a) == levelName(b); }),
+              files.end());
+  return files;
+}
+}  // namespace
+
+Simulation::Simulation(unsigned int width,
+                       unsigned int height,
+                       std::uint64_t seed)
+    : Width(width)
+    , Height(height)
+    , m_seed(seed)
+    , m_random(seed, RandomStream::Gameplay)
+{
+}
+
+void Simulation::SetSeed(std::uint64_t seed)
+{
+  m_seed = seed;
+  m_random = Random(seed, RandomStream::Gameplay);
+}
+
+void Simulation::Init(const std::filesystem::path& levelDirectory)
+{
+  // load levels; they are kept as loaded and only reset while playing
+  this->m_levelFiles = findLevels(levelDirectory);
+  for (const fs::path& file : this->m_levelFiles) {
+    GameLevel level;
+    level.Load(file.string().c_str(), this->Width, this->Height / 2);
+    this->Levels.push_back(std::move(level));
+  }
+  if (this->Levels.empty()) {
+    std::cout << "ERROR::SIMULATION: No levels found in "
+              << levelDirectory.string() << std::endl;
+    this->Levels.emplace_back();
+  }
+  this->Level = 0;
+  // configure game objects
+  glm::vec2 playerPos = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
+                                  this->Height - PLAYER_SIZE.y);
+  Player = GameObject(playerPos, PLAYER_SIZE);
+
+  glm::vec2 ballPos = playerPos
+      + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS, -BALL_RADIUS * 2.0f);
+  Ball = BallObject(ballPos, BALL_RADIUS, INITIAL_BALL_VELOCITY);
+  // reserve room for a busy step so emitting never allocates mid-game
+  m_events.reserve(64);
+}
+
+void Simulation::Start()
+{
+  if (this->State == GAME_MENU)
+    this->State = GAME_ACTIVE;
+}
+
+void Simulation::SelectNextLevel()
+{
+  if (this->State == GAME_MENU && !this->Levels.empty())
+    this->Level =
+        (this->Level + 1) % static_cast<unsigned int>(this->Levels.size());
+}
+
+void Simulation::SelectPreviousLevel()
+{
+  if (this->State == GAME_MENU && !this->Levels.empty()) {
+    if (this->Level > 0)
+      --this->Level;
+    else
+      this->Level = static_cast<unsigned int>(this->Levels.size()) - 1;
+  }
+}
+
+/**
+ * @brief Toggles hard mode.
+ *
+ * Modifies the acceleration factor that affects the ball velocity after each
+ * bounce with the paddle.
+ */
+void Simulation::ToggleHardMode()
+{
+  m_options.hardModeOn = !m_options.hardModeOn;
+  m_options.accelerationFactor = m_options.hardModeOn
+      ? HardMode::accelerationFactor
+      : Classic::accelerationFactor;
+}
+
+void Simulation::ReturnToMenu()
+{
+  if (this->State == GAME_WIN) {
+    Effects.Chaos = false;
+    this->State = GAME_MENU;
+  }
+}
+
+void Simulation::Step(float dt, const SimInput& input)
+{
+  m_events.clear();
+  if (this->State == GAME_ACTIVE)
+    this->processInput(dt, input);
+  this->update(dt);
+}
+
+void Simulation::processInput(float dt, const SimInput& input)
+{
+  float velocity = PLAYER_VELOCITY * dt;
+  // move playerboard
+  if (input.MoveLeft) {
+    if (Player.Position.x >= 0.0f) {
+      Player.Position.x -= velocity;
+      if (Ball.Stuck)
+        Ball.Position.x -= velocity;
+    }
+  }
+  if (input.MoveRight) {
+    if (Player.Position.x <= this->Width - Player.Size.x) {
+      Player.Position.x += velocity;
+      if (Ball.Stuck)
+        Ball.Position.x += velocity;
+    }
+  }
+  if (input.Launch)
+    Ball.Stuck = false;
+}
+
+void Simulation::update(float dt)
+{
+  // update objects
+  this->moveBall(dt);
+  // check for collisions
+  this->doCollisions();
+  // update PowerUps
+  this->updatePowerUps(dt);
+  // reduce shake time
+  if (m_shakeTime > 0.0f) {
+    m_shakeTime -= dt;
+    if (m_shakeTime <= 0.0f)
+      Effects.Shake = false;
+  }
+  // check loss condition
+  if (Ball.Position.y >= this->Height)  // did ball reach bottom edge?
+  {
+    --this->Lives;
+    this->emit(SimEventType::LifeLost, Ball.Position);
+    // did the player lose all his lives? : game over
+    if (this->Lives == 0) {
+      this->resetLevel();
+      this->State = GAME_MENU;
+    }
+    this->resetPlayer();
+  }
+  // check win condition
+  if (this->State == GAME_ACTIVE && this->Levels[this->Level].IsCompleted()) {
+    this->resetLevel();
+    this->resetPlayer();
+    Effects.Chaos = true;
+    this->State = GAME_WIN;
+    this->emit(SimEventType::LevelCompleted, Ball.Position);
+  }
+}
+
+bool Simulation::ReloadLevel(const std::filesystem::path& file)
+{
+  if (!isLevelFile(file))
+    return false;
+  const std::string path = file.lexically_normal().string();
+  const fs::path changed = levelName(file);
+  for (std::size_t i = 0; i < this->m_levelFiles.size(); ++i) {
+    if (changed != levelName(this->m_levelFiles[i]))
+      continue;
+    // a file that is empty or still being written leaves the level as it was
+    GameLevel loaded;
+    loaded.Load(path.c_str(), this->Width, this->Height / 2);
+    if (loaded.Bricks.Count() == 0)
+      return false;
+    this->Levels[i] = std::move(loaded);
+    return true;
+  }
+  return false;
+}
+
+void Simulation::resetLevel()
+{
+  // the level is kept as loaded, only its destroyed bricks are cleared
+  if (this->Level < this->Levels.size())
+    this->Levels[this->Level].Reset();
+
+  this->Lives = 3;
+}
+
+void Simulation::resetPlayer()
+{
+  // reset player/ball stats
+  Player.Size = PLAYER_SIZE;
+  Player.Position = glm::vec2(this->Width / 2.0f - PLAYER_SIZE.x / 2.0f,
+                              this->Height - PLAYER_SIZE.y);
+  Ball.Reset(Player.Position
+                 + glm::vec2(PLAYER_SIZE.x / 2.0f - BALL_RADIUS,
+                             -(BALL_RADIUS * 2.0f)),
+             INITIAL_BALL_VELOCITY);
+  // also disable all active powerups
+  Effects.Chaos = Effects.Confuse = false;
+  Ball.PassThrough = Ball.Sticky = false;
+  Player.Color = glm::vec3(1.0f);
+  Ball.Color = glm::vec3(1.0f);
+  // TODO: Rest all powerups floating down
+}
+
+// Powerups
+void Simulation::updatePowerUps(float dt)
+{
+  this->PowerUps.ForEach(
+      [this, dt](std::size_t slot, PowerUp& powerUp)
+      {
+        powerUp.Position += powerUp.Velocity * dt;
+        if (powerUp.Activated) {
+          powerUp.Duration -= dt;
+          if (powerUp.Duration <= 0.0f) {
+            powerUp.Activated = false;
+            this->deactivatePowerUp(powerUp.Type);
+          }
+        }
+        // free the slots of power-ups that are destroyed and not activated
+        // (thus either off the map or finished)
+        if (powerUp.Destroyed && !powerUp.Activated)
+          this->PowerUps.Remove(slot);
+      });
+}
+
+bool Simulation::shouldSpawn(unsigned int chance)
+{
+  return m_random.Below(chance) == 0;
+}
+
+void Simulation::spawnPowerUps(glm::vec2 position)
+{
+  for (std::size_t type = 0; type < POWERUP_TYPE_COUNT; ++type)
+    if (shouldSpawn(POWERUP_INFO[type].Chance))
+      this->PowerUps.Spawn(static_cast<PowerUpType>(type), position);
+}
+
+void Simulation::activatePowerUp(const PowerUp& powerUp)
+{
+  ++m_activePowerUps[static_cast<std::size_t>(powerUp.Type)];
+  switch (powerUp.Type) {
+    case PowerUpType::Speed:
+      Ball.Velocity *= 1.2;
+      break;
+    case PowerUpType::Sticky:
+      Ball.Sticky = true;
+      Player.Color = glm::vec3(1.0f, 0.5f, 1.0f);
+      break;
+    case PowerUpType::PassThrough:
+      Ball.PassThrough = true;
+      Ball.Color = glm::vec3(1.0f, 0.5f, 0.5f);
+      break;
+    case PowerUpType::PadSizeIncrease:
+      Player.Size.x += 50;
+      break;
+    case PowerUpType::Confuse:
+      if (!Effects.Chaos)
+        Effects.Confuse = true;  // only activate if chaos wasn't already active
+      break;
+    case PowerUpType::Chaos:
+      if (!Effects.Confuse)
+        Effects.Chaos = true;
+      break;
+  }
+}
+
+void Simulation::deactivatePowerUp(PowerUpType type)
+{
+  // the effect lasts as long as any power-up of its type is active
+  if (--m_activePowerUps[static_cast<std::size_t>(type)] > 0)
+    return;
+  switch (type) {
+    case PowerUpType::Sticky:
+      Ball.Sticky = false;
+      Player.Color = glm::vec3(1.0f);
+      break;
+    case PowerUpType::PassThrough:
+      Ball.PassThrough = false;
+      Ball.Color = glm::vec3(1.0f);
+      break;
+    case PowerUpType::Confuse:
+      Effects.Confuse = false;
+      break;
+    case PowerUpType::Chaos:
+      Effects.Chaos = false;
+      break;
+    case PowerUpType::Speed:
+    case PowerUpType::PadSizeIncrease:
+      break;
+  }
+}
+
+bool Simulation::IsPowerUpActive(PowerUpType type) const
+{
+  return m_activePowerUps[static_cast<std::size_t>(type)] > 0;
+}
+
+void Simulation::emit(SimEventType type, glm::vec2 position)
+{
+  m_events.push_back(SimEvent {type, position});
+}
+
+// Ball movement
+void Simulation::moveBall(float dt)
+{
+  // if not stuck to player board
+  if (Ball.Stuck)
+    return;
+
+  // the window's left, right and top edges as boxes the ball bounces off
+  const glm::vec2 window(static_cast<float>(this->Width),
+                         static_cast<float>(this->Height));
+  const glm::vec2 walls[][2] = {
+      {glm::vec2(-window.x, -window.y), glm::vec2(0.0f, 2.0f * window.y)},
+      {glm::vec2(window.x, -window.y), 2.0f * window},
+      {-window, glm::vec2(2.0f * window.x, 0.0f)}};
+
+  // move the ball to its first contact, bounce, and go on with the rest of
+  // the step; a fast ball may bounce several times per step
+  float remaining = 1.0f;  // fraction of this step's motion left
+  for (unsigned int bounce = 0; bounce < MAX_BALL_BOUNCES && remaining > 0.0f;
+       ++bounce)
+  {
+    const glm::vec2 motion = Ball.Velocity * dt * remaining;
+    const glm::vec2 center = Ball.Position + Ball.Radius;
+
+    std::optional<SweepHit> first;
+    std::optional<unsigned int> brick;
+    bool paddle = false;
+    auto consider = [&](glm::vec2 boxMin, glm::vec2 boxMax) -> bool
+    {
+      auto hit =
+          SweepCircleAabb(center, Ball.Radius, motion, boxMin, boxMax);
+      if (!hit || (first && first->Time <= hit->Time))
+        return false;
+      first = hit;
+      brick.reset();
+      paddle = false;
+      return true;
+    };
+    for (const auto& wall : walls)
+      consider(wall[0], wall[1]);
+    paddle = consider(Player.Position, Player.Position + Player.Size);
+    // only bricks on the tiles the ball sweeps over can be hit
+    const BrickLayout& bricks = this->Levels[this->Level].Bricks;
+    this->Levels[this->Level].ForEachBrickIn(
+        glm::min(Ball.Position, Ball.Position + motion),
+        glm::max(Ball.Position, Ball.Position + motion) + Ball.Size,
+        [&](unsigned int index)
+        {
+          const glm::vec2 boxMin = bricks.Positions[index];
+          if (consider(boxMin, boxMin + bricks.Size))
+            brick = index;
+        });
+
+    if (!first) {
+      Ball.Position += motion;
+      break;
+    }
+    Ball.Position += motion * first->Time;
+    remaining *= 1.0f - first->Time;
+    if (brick) {
+      this->hitBrick(*brick, first->Normal);
+    } else if (paddle) {
+      this->hitPaddle();
+      if (Ball.Stuck)
+        break;
+    } else {
+      Ball.Velocity = glm::reflect(Ball.Velocity, first->Normal);
+    }
+  }
+}
+
+void Simulation::hitBrick(unsigned int index, glm::vec2 normal)
+{
+  GameLevel& level = this->Levels[this->Level];
+  const glm::vec2 position = level.Bricks.Positions[index];
+  const bool solid = level.Bricks.IsSolid(index);
+  // destroy block if not solid
+  if (!solid) {
+    level.Destroy(index);
+    this->spawnPowerUps(position);
+    this->emit(SimEventType::BrickDestroyed, position);
+  } else {  // if block is solid, enable shake effect
+    m_shakeTime = 0.05f;
+    Effects.Shake = true;
+    this->emit(SimEventType::SolidBrickHit, position);
+  }
+  // don't bounce off non-solid bricks if pass-through is activated
+  if (!(Ball.PassThrough && !solid))
+    Ball.Velocity = glm::reflect(Ball.Velocity, normal);
+}
+
+void Simulation::hitPaddle()
+{
+  // check where it hit the board, and change velocity based on where it hit
+  // the board
+  float centerBoard = Player.Position.x + Player.Size.x / 2.0f;
+  float distance = (Ball.Position.x + Ball.Radius) - centerBoard;
+  float percentage = distance / (Player.Size.x / 2.0f);
+  // then move accordingly
+  float strength = 2.0f;
+  glm::vec2 oldVelocity = Ball.Velocity;
+  Ball.Velocity.x = INITIAL_BALL_VELOCITY.x * percentage * strength;
+  // Ball.Velocity.y = -Ball.Velocity.y;
+  Ball.Velocity = glm::normalize(Ball.Velocity)
+      * glm::length(oldVelocity);  // keep speed consistent over both axes
+                                   // (multiply by length of old velocity, so
+                                   // total strength is not changed)
+  // fix sticky paddle
+  Ball.Velocity.y = -1.0f * std::abs(Ball.Velocity.y);
+
+  Ball.Velocity *= m_options.accelerationFactor;
+
+  // if Sticky powerup is activated, also stick ball to paddle once new
+  // velocity vectors were calculated
+  Ball.Stuck = Ball.Sticky;
+
+  this->emit(SimEventType::PaddleHit, Ball.Position);
+}
+
+// Collision detection
+void Simulation::doCollisions()
+{
+  // check collisions on PowerUps and if so, activate them
+  this->PowerUps.ForEach(
+      [this](std::size_t, PowerUp& powerUp)
+      {
+        if (powerUp.Destroyed)
+          return;
+        // first check if powerup passed bottom edge, if so: keep as inactive
+        // and destroy
+        if (powerUp.Position.y >= this->Height)
+          powerUp.Destroyed = true;
+
+        if (checkCollision(Player, powerUp))
+        {  // collided with player, now activate powerup
+          activatePowerUp(powerUp);
+          powerUp.Destroyed = true;
+          powerUp.Activated = true;
+          this->emit(SimEventType::PowerUpActivated, powerUp.Position);
+        }
+      });
+}
+
+bool Simulation::checkCollision(const GameObject& one,
+                                const GameObject& two)
+    const  // AABB - AABB collision
+{
+  // collision x-axis?
+  bool collisionX = one.Position.x + one.Size.x >= two.Position.x
+      && two.Position.x + two.Size.x >= one.Position.x;
+  // collision y-axis?
+  bool collisionY = one.Position.y + one.Size.y >= two.Position.y
+      && two.Position.y + two.Size.y >= one.Position.y;
+  // collision only if on both axes
+  return collisionX && collisionY;
+}
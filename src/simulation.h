@@ -0,0 +1,195 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+#include "ball_object.h"
+#include "game_level.h"
+#include "game_object.h"
+#include "power_up.h"
+#include "random.h"
+
+#include <glm/glm.hpp>
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// TODO: Use enum class
+// Represents the current state of the game
+enum GameState
+{
+  GAME_ACTIVE,
+  GAME_MENU,
+  GAME_WIN
+};
+
+namespace Classic
+{
+constexpr float accelerationFactor = 1.0f;
+}
+
+namespace HardMode
+{
+constexpr float accelerationFactor = 1.05f;
+}
+
+// TODO: Change to lowercase
+// TODO: Use constexpr/constinit
+// Initial size of the player paddle
+const glm::vec2 PLAYER_SIZE(100.0f, 20.0f);
+// Initial velocity of the player paddle
+const float PLAYER_VELOCITY(500.0f);
+// Initial velocity of the Ball
+const glm::vec2 INITIAL_BALL_VELOCITY(100.0f, -350.0f);
+// Radius of the ball object
+const float BALL_RADIUS = 12.5f;
+// Bounces the ball may take in a single step; the rest of a step's motion
+// is dropped once they are used up
+const unsigned int MAX_BALL_BOUNCES = 8;
+
+// Player commands sampled for a single simulation step
+struct SimInput
+{
+  bool MoveLeft = false;
+  bool MoveRight = false;
+  bool Launch = false;
+};
+
+// Kinds of gameplay events the simulation reports to its client
+enum class SimEventType
+{
+  BrickDestroyed,
+  SolidBrickHit,
+  PaddleHit,
+  PowerUpActivated,
+  LifeLost,
+  LevelCompleted
+};
+
+// A single gameplay event, used by the client to play sounds or trigger
+// visual effects
+struct SimEvent
+{
+  SimEventType Type;
+  glm::vec2 Position;
+};
+
+// Screen effects toggled by gameplay. They are part of the simulation since
+// power-ups depend on them (confuse and chaos exclude each other); the client
+// mirrors them onto its PostProcessor.
+struct SimEffects
+{
+  bool Confuse = false;
+  bool Chaos = false;
+  bool Shake = false;
+};
+
+// Simulation holds the complete gameplay state of a Breakout game: ball,
+// paddle, bricks and power-ups. It only depends on the CPU, so it can be
+// stepped without a window, GL context or audio device. Everything a
+// presentation layer needs to react to is reported through Events().
+class Simulation
+{
+public:
+  // constructor; the seed decides everything left to chance, so a game with
+  // the same seed and input plays out the same on every platform
+  Simulation(unsigned int width, unsigned int height, std::uint64_t seed = 0);
+
+  // loads every level in levelDirectory, ordered by file name, and places
+  // paddle and ball
+  void Init(const std::filesystem::path& levelDirectory = "levels");
+
+  // menu commands
+  void Start();
+  void SelectNextLevel();
+  void SelectPreviousLevel();
+  void ToggleHardMode();
+  void ReturnToMenu();
+
+  // loads a level again from file, its text or binary file, in place, e.g.
+  // after it was edited; false if file isn't one of the levels or holds no
+  // bricks
+  bool ReloadLevel(const std::filesystem::path& file);
+
+  // advances the game by dt seconds using the given player input; clears
+  // the events of the previous step
+  void Step(float dt, const SimInput& input);
+
+  // events produced by the last call to Step
+  const std::vector<SimEvent>& Events() const { return m_events; }
+
+  // Data
+  GameState State = GAME_MENU;
+  unsigned int Width;
+  unsigned int Height;
+  std::vector<GameLevel> Levels;
+  PowerUpPool PowerUps;
+  unsigned int Level = 0;
+  unsigned int Lives = 3;
+
+  GameObject Player {};
+  BallObject Ball {};
+  SimEffects Effects {};
+
+  bool IsHardModeOn() const { return m_options.hardModeOn; }
+  // starts the gameplay random numbers over from the seed
+  void SetSeed(std::uint64_t seed);
+  std::uint64_t GetSeed() const { return m_seed; }
+  // whether a power-up of the type was picked up and hasn't run out yet
+  bool IsPowerUpActive(PowerUpType type) const;
+
+private:
+  // Step phases
+  void processInput(float dt, const SimInput& input);
+  void update(float dt);
+
+  // Ball movement; sweeps the ball through the step so it can't tunnel
+  void moveBall(float dt);
+  void hitBrick(unsigned int index, glm::vec2 normal);
+  void hitPaddle();
+
+  // Collisions
+  void doCollisions();
+  bool checkCollision(const GameObject& one, const GameObject& two) const;
+
+  // Reset
+  void resetLevel();
+  void resetPlayer();
+
+  // Power ups
+  void updatePowerUps(float dt);
+  bool shouldSpawn(unsigned int chance);
+  void spawnPowerUps(glm::vec2 position);
+  void activatePowerUp(const PowerUp& powerUp);
+  // ends the effect of a power-up that ran out, unless another power-up of
+  // its type is still active
+  void deactivatePowerUp(PowerUpType type);
+
+  void emit(SimEventType type, glm::vec2 position);
+
+  std::uint64_t m_seed;
+  Random m_random;
+  float m_shakeTime = 0.0f;
+  std::vector<SimEvent> m_events;
+  // active power-ups by type
+  std::array<unsigned int, POWERUP_TYPE_COUNT> m_activePowerUps {};
+  // the file each level was loaded from
+  std::vector<std::filesystem::path> m_levelFiles;
+
+  struct Options
+  {
+    bool hardModeOn = false;
+    float accelerationFactor = Classic::accelerationFactor;
+  };
+  Options m_options {};
+};
+
+#endif
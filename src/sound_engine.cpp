@@ -2,6 +2,34 @@
 
 #ifndef DISABLE_AUDIO
 
+#include <vector>
+
+namespace
+{
+// A sound file decoded into memory
+struct Samples
+{
+  std::vector<sf::Int16> Data;
+  unsigned int ChannelCount = 0;
+  unsigned int SampleRate = 0;
+};
+
+Samples decodeSound(const std::string& filename)
+{
+  sf::InputSoundFile file;
+  if (not file.openFromFile(filename)) {
+    throw std::runtime_error {"Unable to load file"};
+  }
+  Samples samples;
+  samples.ChannelCount = file.getChannelCount();
+  samples.SampleRate = file.getSampleRate();
+  samples.Data.resize(static_cast<std::size_t>(file.getSampleCount()));
+  const sf::Uint64 read = file.read(samples.Data.data(), samples.Data.size());
+  samples.Data.resize(static_cast<std::size_t>(read));
+  return samples;
+}
+}  // namespace
+
 void SoundEngine::loadSound(const std::string& filename)
 {
   sf::SoundBuffer buffer {};
@@ -14,6 +42,30 @@ void SoundEngine::loadSound(const std::string& filename)
   }
 }
 
+AssetHandle SoundEngine::loadSoundAsync(AssetLoader& loader,
+                                        const std::string& filename)
+{
+  return loader.Load(
+      filename,
+      [filename] { return decodeSound(filename); },
+      [this, filename](Samples samples)
+      {
+        // the OpenAL buffer is created here, on the thread that polls
+        sf::SoundBuffer buffer {};
+        if (not buffer.loadFromSamples(samples.Data.data(),
+                                       samples.Data.size(),
+                                       samples.ChannelCount,
+                                       samples.SampleRate))
+        {
+          throw std::runtime_error {"Unable to load file"};
+        }
+        auto [it, success] = m_soundBuffersByName.insert({filename, buffer});
+        if (not success) {
+          throw std::runtime_error {"Sound file already loaded"};
+        }
+      });
+}
+
 void SoundEngine::play2D(const std::string& filename, bool loop)
 {
   auto search = m_soundBuffersByName.find(filename);
@@ -39,6 +91,12 @@ void SoundEngine::playMusic(const std::string& filename, bool loop)
 // If audio is disabled, the following functions are just no-ops
 void SoundEngine::loadSound(const std::string& filename) {}
 
+AssetHandle SoundEngine::loadSoundAsync(AssetLoader& loader,
+                                        const std::string& filename)
+{
+  return loader.Load(filename, [] { return 0; }, [](int) {});
+}
+
 void SoundEngine::play2D(const std::string& filename, bool loop) {}
 
 void SoundEngine::playMusic(const std::string& filename, bool loop) {}
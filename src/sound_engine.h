@@ -1,5 +1,7 @@
 #pragma once
 
+#include "asset_loader.h"
+
 #ifndef DISABLE_AUDIO
 // clang-format off
 #include <SFML/Audio.hpp>
@@ -27,6 +29,9 @@ public:
 
   // Functions
   void loadSound(const std::string& filename);
+  // Decodes the file on one of the loader's workers; the sound can be played
+  // once the loader finished the returned handle
+  AssetHandle loadSoundAsync(AssetLoader& loader, const std::string& filename);
   void play2D(const std::string& filename, bool loop);
   void playMusic(const std::string& filename, bool loop = true);
 
@@ -0,0 +1,237 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "sprite_batch.h"
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+SpriteBatch::SpriteBatch(Shader& program, unsigned int initialCapacity)
+    : shader(program)
+{
+  this->initRenderData();
+  this->reserve(initialCapacity);
+}
+
+SpriteBatch::SpriteBatch(SpriteBatch&& other) noexcept
+    : shader(other.shader)
+    , quadVAO(std::exchange(other.quadVAO, 0))
+    , quadVBO(std::exchange(other.quadVBO, 0))
+    , instanceVBO(std::exchange(other.instanceVBO, 0))
+    , capacity(std::exchange(other.capacity, 0))
+    , buckets(std::move(other.buckets))
+    , staging(std::move(other.staging))
+    , stats(other.stats)
+{
+}
+
+SpriteBatch& SpriteBatch::operator=(SpriteBatch&& other) noexcept
+{
+  if (this != &other) {
+    this->release();
+    this->shader = other.shader;
+    this->quadVAO = std::exchange(other.quadVAO, 0);
+    this->quadVBO = std::exchange(other.quadVBO, 0);
+    this->instanceVBO = std::exchange(other.instanceVBO, 0);
+    this->capacity = std::exchange(other.capacity, 0);
+    this->buckets = std::move(other.buckets);
+    this->staging = std::move(other.staging);
+    this->stats = other.stats;
+  }
+  return *this;
+}
+
+SpriteBatch::~SpriteBatch()
+{
+  this->release();
+}
+
+void SpriteBatch::release()
+{
+  if (this->quadVAO == 0)
+    return;
+  glDeleteVertexArrays(1, &this->quadVAO);
+  glDeleteBuffers(1, &this->quadVBO);
+  glDeleteBuffers(1, &this->instanceVBO);
+  this->quadVAO = this->quadVBO = this->instanceVBO = 0;
+}
+
+void SpriteBatch::Begin()
+{
+  this->stats = Stats {};
+}
+
+void SpriteBatch::Draw(const Texture2D& texture,
+                       glm::vec2 position,
+                       glm::vec2 size,
+                       float rotate,
+                       glm::vec3 color,
+                       glm::vec4 texRect)
+{
+  // a frame only uses a handful of textures, so a linear search is the
+  // cheapest way to find the bucket
+  Bucket* bucket = nullptr;
+  for (Bucket& candidate : this->buckets) {
+    if (candidate.TextureID == texture.ID) {
+      bucket = &candidate;
+      break;
+    }
+  }
+  if (bucket == nullptr) {
+    this->buckets.push_back(Bucket {texture.ID, {}});
+    bucket = &this->buckets.back();
+  }
+  bucket->Instances.push_back(
+      SpriteInstance {position, size, color, rotate, texRect});
+}
+
+void SpriteBatch::Draw(const TextureRegion& region,
+                       glm::vec2 position,
+                       glm::vec2 size,
+                       float rotate,
+                       glm::vec3 color)
+{
+  this->Draw(*region.Texture, position, size, rotate, color, region.Rect);
+}
+
+void SpriteBatch::Flush()
+{
+  const auto start = std::chrono::steady_clock::now();
+
+  // gather all queued sprites into one contiguous upload
+  this->staging.clear();
+  for (const Bucket& bucket : this->buckets)
+    this->staging.insert(this->staging.end(),
+                         bucket.Instances.begin(),
+                         bucket.Instances.end());
+  if (this->staging.empty())
+    return;
+
+  const auto count = static_cast<unsigned int>(this->staging.size());
+  this->reserve(count);
+  glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+  // orphan the previous contents so the driver doesn't stall on draws that
+  // still read from them
+  const auto bytes = this->capacity * sizeof(SpriteInstance);
+  glBufferData(
+      GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  0,
+                  static_cast<GLsizeiptr>(count * sizeof(SpriteInstance)),
+                  this->staging.data());
+
+  this->shader.Use();
+  glActiveTexture(GL_TEXTURE0);
+  glBindVertexArray(this->quadVAO);
+  unsigned int first = 0;
+  for (Bucket& bucket : this->buckets) {
+    if (bucket.Instances.empty())
+      continue;
+    const auto instances = static_cast<GLsizei>(bucket.Instances.size());
+    this->setInstanceOffset(first);
+    glBindTexture(GL_TEXTURE_2D, bucket.TextureID);
+    glDrawArraysInstanced(GL_TRIANGLES, 0, 6, instances);
+    ++this->stats.TextureBinds;
+    ++this->stats.DrawCalls;
+    first += static_cast<unsigned int>(instances);
+    bucket.Instances.clear();
+  }
+  glBindVertexArray(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  this->stats.Sprites += count;
+
+  const std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  this->stats.SubmitMilliseconds += elapsed.count();
+}
+
+void SpriteBatch::End()
+{
+  this->Flush();
+}
+
+void SpriteBatch::initRenderData()
+{
+  // clang-format off
+  float vertices[] = {
+    // pos      // tex
+    0.0f, 1.0f, 0.0f, 1.0f,
+    1.0f, 0.0f, 1.0f, 0.0f,
+    0.0f, 0.0f, 0.0f, 0.0f,
+
+    0.0f, 1.0f, 0.0f, 1.0f,
+    1.0f, 1.0f, 1.0f, 1.0f,
+    1.0f, 0.0f, 1.0f, 0.0f
+  };
+  // clang-format on
+
+  glGenVertexArrays(1, &this->quadVAO);
+  glGenBuffers(1, &this->quadVBO);
+  glGenBuffers(1, &this->instanceVBO);
+
+  glBindVertexArray(this->quadVAO);
+  glBindBuffer(GL_ARRAY_BUFFER, this->quadVBO);
+  glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+  glEnableVertexAttribArray(0);
+  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), nullptr);
+
+  // per-instance attributes advance once per sprite
+  glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+  for (GLuint location = 1; location <= 3; ++location) {
+    glEnableVertexAttribArray(location);
+    glVertexAttribDivisor(location, 1);
+  }
+  this->setInstanceOffset(0);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glBindVertexArray(0);
+}
+
+void SpriteBatch::reserve(unsigned int count)
+{
+  if (count <= this->capacity)
+    return;
+  this->capacity = count;
+  const auto bytes = this->capacity * sizeof(SpriteInstance);
+  glBindBuffer(GL_ARRAY_BUFFER, this->instanceVBO);
+  glBufferData(
+      GL_ARRAY_BUFFER, static_cast<GLsizeiptr>(bytes), nullptr, GL_STREAM_DRAW);
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+// Expects the VAO and instance buffer to be bound. GL 3.3 has no base
+// instance, so each texture's range is selected by moving the attribute
+// pointers instead.
+void SpriteBatch::setInstanceOffset(unsigned int first)
+{
+  const auto stride = static_cast<GLsizei>(sizeof(SpriteInstance));
+  const std::size_t base = first * sizeof(SpriteInstance);
+  auto offset = [base](std::size_t member)
+  { return reinterpret_cast<const void*>(base + member); };
+  // <vec2 position, vec2 size>
+  glVertexAttribPointer(1,
+                        4,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        stride,
+                        offset(offsetof(SpriteInstance, Position)));
+  // <vec3 color, float rotation>
+  glVertexAttribPointer(2,
+                        4,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        stride,
+                        offset(offsetof(SpriteInstance, Color)));
+  // <vec2 uv offset, vec2 uv scale>
+  glVertexAttribPointer(3,
+                        4,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        stride,
+                        offset(offsetof(SpriteInstance, TexRect)));
+}
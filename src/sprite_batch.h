@@ -0,0 +1,115 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef SPRITE_BATCH_H
+#define SPRITE_BATCH_H
+
+#include "shader.h"
+#include "texture.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Per-sprite data streamed to the GPU; matches the instance attributes of
+// shaders/sprite.vert
+struct SpriteInstance
+{
+  glm::vec2 Position;
+  glm::vec2 Size;
+  glm::vec3 Color;
+  float Rotation;  // in degrees
+  glm::vec4 TexRect;  // <vec2 uv offset, vec2 uv scale>
+};
+
+// SpriteBatch collects textured quads and renders them with one instanced
+// draw call per texture. Sprites are grouped by texture on Flush(), so the
+// order between sprites of different textures is only kept across flushes:
+// flush whenever later sprites have to cover earlier ones.
+class SpriteBatch
+{
+public:
+  // Counters of the current frame (since the last Begin())
+  struct Stats
+  {
+    unsigned int Sprites = 0;
+    unsigned int DrawCalls = 0;
+    unsigned int TextureBinds = 0;
+    double SubmitMilliseconds = 0.0;  // CPU time spent in Flush()
+  };
+
+  // Constructor (inits shaders/shapes)
+  SpriteBatch() = default;
+  explicit SpriteBatch(Shader& program, unsigned int initialCapacity = 1024);
+
+  // Owns GL objects, so it can be moved but not copied
+  SpriteBatch(const SpriteBatch&) = delete;
+  SpriteBatch& operator=(const SpriteBatch&) = delete;
+  SpriteBatch(SpriteBatch&& other) noexcept;
+  SpriteBatch& operator=(SpriteBatch&& other) noexcept;
+
+  // Destructor
+  ~SpriteBatch();
+
+  // Draws with another shader from now on, e.g. a reloaded one
+  void SetShader(const Shader& program) { this->shader = program; }
+
+  // Starts a new frame and resets the counters
+  void Begin();
+  // Queues a quad textured with the given sprite
+  void Draw(const Texture2D& texture,
+            glm::vec2 position,
+            glm::vec2 size = glm::vec2(10.0f, 10.0f),
+            float rotate = 0.0f,
+            glm::vec3 color = glm::vec3(1.0f),
+            glm::vec4 texRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+  // Queues a quad textured with a region, e.g. an image of an atlas; sprites
+  // from one atlas share a draw call whatever image they show
+  void Draw(const TextureRegion& region,
+            glm::vec2 position,
+            glm::vec2 size = glm::vec2(10.0f, 10.0f),
+            float rotate = 0.0f,
+            glm::vec3 color = glm::vec3(1.0f));
+  // Renders all queued sprites, one instanced draw call per texture
+  void Flush();
+  // Flushes the remaining sprites
+  void End();
+
+  const Stats& GetStats() const { return stats; }
+
+private:
+  // Sprites sharing a texture; kept across frames to reuse their storage
+  struct Bucket
+  {
+    unsigned int TextureID;
+    std::vector<SpriteInstance> Instances;
+  };
+
+  // Initializes and configures the quad's buffer and vertex attributes
+  void initRenderData();
+  // Makes sure the instance buffer holds at least count sprites
+  void reserve(unsigned int count);
+  // Points the instance attributes at the sprite with the given index
+  void setInstanceOffset(unsigned int first);
+  void release();
+
+  // Render state
+  Shader shader {};
+  unsigned int quadVAO {};
+  unsigned int quadVBO {};
+  unsigned int instanceVBO {};
+  unsigned int capacity {};
+
+  // Queued sprites
+  std::vector<Bucket> buckets;
+  std::vector<SpriteInstance> staging;
+  Stats stats {};
+};
+
+#endif
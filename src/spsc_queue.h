@@ -0,0 +1,57 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// SpscQueue is a fixed-size FIFO for one producer thread and one consumer
+// thread. Push and Pop never block or retry, so each finishes in a bounded
+// number of steps whatever the other thread is doing; when the queue is full
+// Push fails instead of waiting. Capacity must be a power of two.
+template<typename T, std::size_t Capacity>
+class SpscQueue
+{
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                "SpscQueue capacity must be a power of two");
+
+public:
+  // Producer: appends value; false if the queue is full
+  bool Push(const T& value)
+  {
+    const std::size_t back = this->tail.load(std::memory_order_relaxed);
+    if (back - this->head.load(std::memory_order_acquire) == Capacity)
+      return false;
+    this->items[back & (Capacity - 1)] = value;
+    this->tail.store(back + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer: removes the oldest value into value; false if the queue is
+  // empty
+  bool Pop(T& value)
+  {
+    const std::size_t front = this->head.load(std::memory_order_relaxed);
+    if (front == this->tail.load(std::memory_order_acquire))
+      return false;
+    value = this->items[front & (Capacity - 1)];
+    this->head.store(front + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::array<T, Capacity> items {};
+  // both counters only grow; their difference is the number of queued values
+  alignas(64) std::atomic<std::size_t> head {0};
+  alignas(64) std::atomic<std::size_t> tail {0};
+};
+
+#endif
@@ -8,146 +8,309 @@
 ******************************************************************/
 #include "text_renderer.h"
 
+#include "hash.h"
+#include "resource_location.h"
 #include "resource_manager.h"
 
-#include <ft2build.h>
-#include FT_FREETYPE_H
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <format>
 #include <iostream>
+#include <optional>
 
 TextRenderer::TextRenderer(unsigned int width, unsigned int height)
 {
   // load and configure shader
   this->TextShader = ResourceManager::LoadShader(
       "shaders/text_2d.vert", "shaders/text_2d.frag", nullptr, "text");
-  this->TextShader.SetMatrix4(
-      "projection",
-      glm::ortho(
-          0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f),
-      true);
-  this->TextShader.SetInteger("text", 0);
-  // configure VAO/VBO for texture quads
+  this->SdfShader = ResourceManager::LoadShader(
+      "shaders/text_2d.vert", "shaders/text_2d_sdf.frag", nullptr, "text_sdf");
+  const glm::mat4 projection = glm::ortho(
+      0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f);
+  for (Shader* shader : {&this->TextShader, &this->SdfShader}) {
+    shader->SetMatrix4("projection", projection, true);
+    shader->SetInteger("text", 0);
+  }
+  // configure VAO/VBO for texture quads; the buffer is created by reserve()
   glGenVertexArrays(1, &this->VAO);
-  glGenBuffers(1, &this->VBO);
   glBindVertexArray(this->VAO);
-  glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(float) * 6 * 4, NULL, GL_DYNAMIC_DRAW);
   glEnableVertexAttribArray(0);
-  glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4 * sizeof(float), 0);
-  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glEnableVertexAttribArray(1);
   glBindVertexArray(0);
+  // room for a few screens of menu text
+  this->reserve(6 * 1024);
+}
+
+void TextRenderer::Load(std::string font,
+                        unsigned int fontSize,
+                        GlyphMode mode)
+{
+  this->useGlyphs(loadGlyphs(font, fontSize, mode), mode);
+}
+
+AssetHandle TextRenderer::LoadAsync(AssetLoader& loader,
+                                    std::string font,
+                                    unsigned int fontSize,
+                                    GlyphMode mode)
+{
+  return loader.Load(
+      font,
+      [font, fontSize, mode] { return loadGlyphs(font, fontSize, mode); },
+      [this, mode](std::optional<GlyphAtlas> atlas)
+      { this->useGlyphs(atlas, mode); });
+}
+
+std::optional<GlyphAtlas> TextRenderer::loadGlyphs(const std::string& font,
+                                                   unsigned int fontSize,
+                                                   GlyphMode mode)
+{
+  // rendering the glyphs takes a while, SDF glyphs especially; reuse the
+  // atlas of an earlier run if the font hasn't changed since
+  const std::uint64_t key = GlyphAtlasKey(font, fontSize, mode);
+  const fs::path cacheFile = Location::PathToCache(
+      std::format("{}-{}{}.glyphs",
+                  fs::path(font).stem().string(),
+                  fontSize,
+                  mode == GlyphMode::SDF ? "-sdf" : ""));
+  std::optional<GlyphAtlas> atlas = LoadGlyphAtlas(key, cacheFile);
+  if (!atlas) {
+    atlas = BuildGlyphAtlas(font, fontSize, mode);
+    if (atlas && !SaveGlyphAtlas(*atlas, key, cacheFile))
+      std::cout << "WARNING::FREETYPE: Could not cache glyphs in "
+                << cacheFile.string() << std::endl;
+  }
+  return atlas;
 }
 
-void TextRenderer::Load(std::string font, unsigned int fontSize)
+void TextRenderer::useGlyphs(const std::optional<GlyphAtlas>& atlas,
+                             GlyphMode mode)
 {
-  // first clear the previously loaded Characters
-  this->Characters.clear();
-  // then initialize and load the FreeType library
-  FT_Library ft;
-  if (FT_Init_FreeType(&ft))  // all functions return a value different than 0
-                              // whenever an error occurred
-    std::cout << "ERROR::FREETYPE: Could not init FreeType Library"
-              << std::endl;
-  // load font as face
-  FT_Face face;
-  if (FT_New_Face(ft, font.c_str(), 0, &face))
-    std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-  // set size to load glyphs as
-  FT_Set_Pixel_Sizes(face, 0, fontSize);
+  // first clear the previously loaded Characters and their layouts
+  this->Characters.fill(Character {});
+  this->clearLayouts();
+  if (!atlas)
+    return;
+  this->Characters = atlas->Characters;
+  this->ascent = this->Characters['H'].Bearing.y;
+  // SDF glyphs reach beyond their outline by the spread on every side, which
+  // their bearing includes; the cap height is measured to the outline
+  if (mode == GlyphMode::SDF)
+    this->ascent -= static_cast<int>(glyphSdfSpread);
+  this->glyphMode = mode;
+
+  if (this->atlasTexture == 0)
+    glGenTextures(1, &this->atlasTexture);
+  glBindTexture(GL_TEXTURE_2D, this->atlasTexture);
   // disable byte-alignment restriction
   glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-  // then for the first 128 ASCII characters, pre-load/compile their characters
-  // and store them
-  for (GLubyte c = 0; c < 128; c++)  // lol see what I did there
-  {
-    // load character glyph
-    if (FT_Load_Char(face, c, FT_LOAD_RENDER)) {
-      std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
-      continue;
-    }
-    // generate texture
-    unsigned int texture;
-    glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
-    glTexImage2D(GL_TEXTURE_2D,
-                 0,
-                 GL_RED,
-                 face->glyph->bitmap.width,
-                 face->glyph->bitmap.rows,
-                 0,
-                 GL_RED,
-                 GL_UNSIGNED_BYTE,
-                 face->glyph->bitmap.buffer);
-    // set texture options
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-    // now store character for later use
-    Character character = {
-        texture,
-        glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
-        glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
-        static_cast<unsigned int>(face->glyph->advance.x)};
-    Characters.insert(std::pair<char, Character>(c, character));
-  }
+  glTexImage2D(GL_TEXTURE_2D,
+               0,
+               GL_RED,
+               static_cast<GLsizei>(atlas->Width),
+               static_cast<GLsizei>(atlas->Height),
+               0,
+               GL_RED,
+               GL_UNSIGNED_BYTE,
+               atlas->Pixels.data());
+  // set texture options
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
   glBindTexture(GL_TEXTURE_2D, 0);
-  // destroy FreeType once we're finished
-  FT_Done_Face(face);
-  FT_Done_FreeType(ft);
 }
 
+namespace
+{
+// Whether two floats are the same value, bit for bit
+bool sameBits(float a, float b)
+{
+  return std::bit_cast<std::uint32_t>(a) == std::bit_cast<std::uint32_t>(b);
+}
+}  // namespace
+
 void TextRenderer::RenderText(
-    std::string text, float x, float y, float scale, glm::vec3 color)
+    std::string_view text, float x, float y, float scale, glm::vec3 color)
 {
-  // activate corresponding render state
-  this->TextShader.Use();
-  this->TextShader.SetVector3f("textColor", color);
-  glActiveTexture(GL_TEXTURE0);
-  glBindVertexArray(this->VAO);
+  std::uint64_t hash = HashBytes(text.data(), text.size());
+  for (float value : {x, y, scale, color.r, color.g, color.b})
+    hash = HashBytes(&value, sizeof(value), hash);
 
-  // iterate through all characters
-  std::string::const_iterator c;
-  for (c = text.begin(); c != text.end(); c++) {
-    Character ch = Characters[*c];
+  const TextLayout* found = nullptr;
+  if (this->cacheLayouts) {
+    auto it = this->layouts.find(hash);
+    if (it != this->layouts.end()) {
+      const TextLayout& cached = it->second;
+      if (cached.Text == text && sameBits(cached.X, x) && sameBits(cached.Y, y)
+          && sameBits(cached.Scale, scale) && sameBits(cached.Color.r, color.r)
+          && sameBits(cached.Color.g, color.g)
+          && sameBits(cached.Color.b, color.b))
+        found = &cached;
+    }
+  }
+  TextLayout fresh {};
+  if (found == nullptr) {
+    fresh = this->layout(text, x, y, scale, color);
+    ++this->pending.Layouts;
+    if (this->cacheLayouts) {
+      // a hash collision replaces the older string
+      TextLayout& cached = this->layouts[hash];
+      cached = fresh;
+      cached.Text.assign(text);
+      found = &cached;
+    } else {
+      found = &fresh;
+    }
+  }
+  if (found->Count == 0)
+    return;
+  this->firsts.push_back(found->First);
+  this->counts.push_back(found->Count);
+  this->pending.Glyphs += static_cast<unsigned int>(found->Count / 6);
+}
 
-    float xpos = x + ch.Bearing.x * scale;
-    float ypos = y + (this->Characters['H'].Bearing.y - ch.Bearing.y) * scale;
+TextRenderer::TextLayout TextRenderer::layout(
+    std::string_view text, float x, float y, float scale, glm::vec3 color)
+{
+  TextLayout result {{}, x, y, scale, color, 0, 0};
+  this->scratch.clear();
+  for (char c : text) {
+    const auto code = static_cast<unsigned char>(c);
+    if (code >= this->Characters.size())
+      continue;
+    const Character& ch = this->Characters[code];
 
-    float w = ch.Size.x * scale;
-    float h = ch.Size.y * scale;
+    const float xpos = x + static_cast<float>(ch.Bearing.x) * scale;
+    const float ypos =
+        y + static_cast<float>(this->ascent - ch.Bearing.y) * scale;
+    const float w = static_cast<float>(ch.Size.x) * scale;
+    const float h = static_cast<float>(ch.Size.y) * scale;
+    const float u0 = ch.TexRect.x;
+    const float v0 = ch.TexRect.y;
+    const float u1 = ch.TexRect.x + ch.TexRect.z;
+    const float v1 = ch.TexRect.y + ch.TexRect.w;
 
-    // update VBO for each character
     // clang-format off
-    float vertices[6][4] = {
-      { xpos,     ypos + h,   0.0f, 1.0f },
-      { xpos + w, ypos,       1.0f, 0.0f },
-      { xpos,     ypos,       0.0f, 0.0f },
-
-      { xpos,     ypos + h,   0.0f, 1.0f },
-      { xpos + w, ypos + h,   1.0f, 1.0f },
-      { xpos + w, ypos,       1.0f, 0.0f }
+    const Vertex quad[6] = {
+      { glm::vec4(xpos,     ypos + h, u0, v1), color },
+      { glm::vec4(xpos + w, ypos,     u1, v0), color },
+      { glm::vec4(xpos,     ypos,     u0, v0), color },
+
+      { glm::vec4(xpos,     ypos + h, u0, v1), color },
+      { glm::vec4(xpos + w, ypos + h, u1, v1), color },
+      { glm::vec4(xpos + w, ypos,     u1, v0), color }
     };
     // clang-format on
+    this->scratch.insert(this->scratch.end(), quad, quad + 6);
+
+    // now advance cursors for next glyph (advance is in 1/64 pixels)
+    x += static_cast<float>(ch.Advance >> 6) * scale;
+  }
+  if (this->scratch.empty())
+    return result;
+
+  const std::size_t count = this->scratch.size();
+  this->reserve(count);
+  glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+  glBufferSubData(GL_ARRAY_BUFFER,
+                  static_cast<GLintptr>(this->used * sizeof(Vertex)),
+                  static_cast<GLsizeiptr>(count * sizeof(Vertex)),
+                  this->scratch.data());
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  result.First = static_cast<GLint>(this->used);
+  result.Count = static_cast<GLsizei>(count);
+  this->used += count;
+  return result;
+}
+
+void TextRenderer::Flush()
+{
+  this->stats = this->pending;
+  this->pending = Stats {};
+  if (!this->firsts.empty()) {
+    // activate corresponding render state
+    if (this->glyphMode == GlyphMode::SDF)
+      this->SdfShader.Use();
+    else
+      this->TextShader.Use();
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, this->atlasTexture);
+    glBindVertexArray(this->VAO);
+    glMultiDrawArrays(GL_TRIANGLES,
+                      this->firsts.data(),
+                      this->counts.data(),
+                      static_cast<GLsizei>(this->firsts.size()));
+    glBindVertexArray(0);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    ++this->stats.DrawCalls;
+    this->firsts.clear();
+    this->counts.clear();
+  }
+  // strings that changed leave their old layouts behind; once they take up
+  // most of the buffer, start over and lay out what is still shown next frame
+  if (!this->cacheLayouts || this->used > this->capacity / 4 * 3)
+    this->clearLayouts();
+}
+
+void TextRenderer::SetLayoutCache(bool enabled)
+{
+  this->cacheLayouts = enabled;
+  this->clearLayouts();
+}
+
+void TextRenderer::clearLayouts()
+{
+  this->layouts.clear();
+  this->used = 0;
+}
 
-    // render glyph texture over quad
-    glBindTexture(GL_TEXTURE_2D, ch.TextureID);
-    // update content of VBO memory
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferSubData(
-        GL_ARRAY_BUFFER,
-        0,
-        sizeof(vertices),
-        vertices);  // be sure to use glBufferSubData and not glBufferData
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    // render quad
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    // now advance cursors for next glyph
-    x += (ch.Advance >> 6) * scale;  // bitshift by 6 to get value in pixels
-                                     // (1/64th times 2^6 = 64)
+void TextRenderer::reserve(std::size_t count)
+{
+  const std::size_t needed = this->used + count;
+  if (needed <= this->capacity)
+    return;
+  // grow into a new buffer, keeping the layouts already queued or cached
+  const std::size_t grown = std::max(needed, this->capacity * 2);
+  unsigned int buffer;
+  glGenBuffers(1, &buffer);
+  glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+  glBufferData(GL_COPY_WRITE_BUFFER,
+               static_cast<GLsizeiptr>(grown * sizeof(Vertex)),
+               nullptr,
+               GL_DYNAMIC_DRAW);
+  if (this->used > 0) {
+    glBindBuffer(GL_COPY_READ_BUFFER, this->VBO);
+    glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                        GL_COPY_WRITE_BUFFER,
+                        0,
+                        0,
+                        static_cast<GLsizeiptr>(this->used * sizeof(Vertex)));
+    glBindBuffer(GL_COPY_READ_BUFFER, 0);
   }
+  glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+  glDeleteBuffers(1, &this->VBO);
+  this->VBO = buffer;
+  this->capacity = grown;
+
+  // point the attributes at the new buffer
+  glBindVertexArray(this->VAO);
+  glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
+  glVertexAttribPointer(0,
+                        4,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        sizeof(Vertex),
+                        reinterpret_cast<const void*>(
+                            offsetof(Vertex, PositionTexCoords)));
+  glVertexAttribPointer(1,
+                        3,
+                        GL_FLOAT,
+                        GL_FALSE,
+                        sizeof(Vertex),
+                        reinterpret_cast<const void*>(offsetof(Vertex, Color)));
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
   glBindVertexArray(0);
-  glBindTexture(GL_TEXTURE_2D, 0);
 }
@@ -9,50 +9,136 @@
 #ifndef TEXT_RENDERER_H
 #define TEXT_RENDERER_H
 
+#include "asset_loader.h"
+#include "glyph_atlas.h"
 #include "shader.h"
 #include "texture.h"
 
 #include <glad/glad.h>
 #include <glm/glm.hpp>
 
-#include <map>
-
-/// Holds all state information relevant to a character as loaded using FreeType
-struct Character
-{
-  unsigned int TextureID;  // ID handle of the glyph texture
-  glm::ivec2 Size;  // size of glyph
-  glm::ivec2 Bearing;  // offset from baseline to left/top of glyph
-  unsigned int Advance;  // horizontal offset to advance to next glyph
-};
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
 
 // A renderer class for rendering text displayed by a font loaded using the
-// FreeType library. A single font is loaded, processed into a list of Character
-// items for later rendering.
+// FreeType library. A single font is loaded and its ASCII glyphs are packed
+// into one atlas texture, either as bitmaps or as signed distance fields that
+// stay sharp at any scale.
+// Laid out text stays on the GPU: each distinct string, position, scale and
+// color is turned into quads once and kept in a shared vertex buffer, so
+// drawing text that doesn't change costs a hash lookup. All text queued
+// between two Flush() calls is drawn with one draw call.
 class TextRenderer
 {
 public:
+  // Counters of the last Flush()
+  struct Stats
+  {
+    unsigned int Glyphs = 0;
+    unsigned int DrawCalls = 0;
+    unsigned int Layouts = 0;  // strings that had to be laid out
+  };
+
   // Constructor
   TextRenderer() = default;
   TextRenderer(unsigned int width, unsigned int height);
 
-  // Pre-compiles a list of characters from the given font
-  void Load(std::string font, unsigned int fontSize);
-  // Renders a string of text using the precompiled list of characters
-  void RenderText(std::string text,
+  // Pre-compiles a list of characters from the given font; drops all cached
+  // layouts. The glyph atlas is cached on disk for the next run.
+  void Load(std::string font,
+            unsigned int fontSize,
+            GlyphMode mode = GlyphMode::Bitmap);
+  // Load, with the glyphs read from the cache or rendered on one of the
+  // loader's workers; the atlas texture is created when the loader finishes
+  // the returned handle. The renderer must stay in place until then.
+  AssetHandle LoadAsync(AssetLoader& loader,
+                        std::string font,
+                        unsigned int fontSize,
+                        GlyphMode mode = GlyphMode::Bitmap);
+  // Queues a string of text using the precompiled list of characters;
+  // characters outside ASCII are skipped
+  void RenderText(std::string_view text,
                   float x,
                   float y,
                   float scale,
                   glm::vec3 color = glm::vec3(1.0f));
+  // Draws all queued text
+  void Flush();
+
+  // Turns the layout cache on or off (it is on by default); without it all
+  // text is laid out and uploaded again every frame
+  void SetLayoutCache(bool enabled);
+
+  const Stats& GetStats() const { return stats; }
 
 private:
-  // holds a list of pre-compiled Characters
-  std::map<char, Character> Characters;
-  // shader used for text rendering
+  // A corner of a glyph quad; matches the attributes of shaders/text_2d.vert
+  struct Vertex
+  {
+    glm::vec4 PositionTexCoords;  // <vec2 pos, vec2 tex>
+    glm::vec3 Color;
+  };
+
+  // A string laid out into the vertex buffer
+  struct TextLayout
+  {
+    std::string Text;
+    float X, Y, Scale;
+    glm::vec3 Color;
+    GLint First;  // first vertex
+    GLsizei Count;  // number of vertices
+  };
+
+  // Reads the glyph atlas of a font from the cache or renders it; doesn't
+  // touch the GL
+  static std::optional<GlyphAtlas> loadGlyphs(const std::string& font,
+                                              unsigned int fontSize,
+                                              GlyphMode mode);
+  // Replaces the glyphs with the atlas, or with nothing if there is none
+  void useGlyphs(const std::optional<GlyphAtlas>& atlas, GlyphMode mode);
+  // Lays text out into the vertex buffer and returns where it went
+  TextLayout layout(std::string_view text,
+                    float x,
+                    float y,
+                    float scale,
+                    glm::vec3 color);
+  // Makes sure the vertex buffer has room for count more vertices, keeping
+  // its contents
+  void reserve(std::size_t count);
+  // Forgets all layouts and reuses their space
+  void clearLayouts();
+
+  // holds the pre-compiled Characters, indexed by their code
+  std::array<Character, 128> Characters {};
+  // distance from the top of a line to the baseline, in pixels
+  int ascent = 0;
+  // all glyph bitmaps
+  unsigned int atlasTexture = 0;
+  GlyphMode glyphMode = GlyphMode::Bitmap;
+  // shaders used for text rendering, one per glyph mode
   Shader TextShader;
+  Shader SdfShader;
+
+  // Layout cache, keyed on a hash of the text and its placement
+  bool cacheLayouts = true;
+  std::unordered_map<std::uint64_t, TextLayout> layouts;
+  std::vector<Vertex> scratch;
+  // vertex ranges queued for the next Flush()
+  std::vector<GLint> firsts;
+  std::vector<GLsizei> counts;
+  Stats pending {};
+  Stats stats {};
 
   // render state
-  unsigned int VAO, VBO;
+  unsigned int VAO = 0, VBO = 0;
+  std::size_t capacity = 0;  // vertices the buffer holds
+  std::size_t used = 0;  // vertices taken by layouts
 };
 
 #endif
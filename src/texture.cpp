@@ -26,7 +26,7 @@ Texture2D::Texture2D()
 
 void Texture2D::Generate(unsigned int width,
                          unsigned int height,
-                         unsigned char* data)
+                         const unsigned char* data)
 {
   this->Width = width;
   this->Height = height;
@@ -50,6 +50,28 @@ void Texture2D::Generate(unsigned int width,
   glBindTexture(GL_TEXTURE_2D, 0);
 }
 
+void Texture2D::AddMipmap(unsigned int level,
+                          unsigned int width,
+                          unsigned int height,
+                          const unsigned char* data)
+{
+  glBindTexture(GL_TEXTURE_2D, this->ID);
+  glTexImage2D(GL_TEXTURE_2D,
+               static_cast<GLint>(level),
+               static_cast<GLint>(this->Internal_Format),
+               static_cast<GLsizei>(width),
+               static_cast<GLsizei>(height),
+               0,
+               this->Image_Format,
+               GL_UNSIGNED_BYTE,
+               data);
+  // without this the texture is incomplete until all levels down to 1x1
+  // exist, and mipmapped filtering samples black
+  glTexParameteri(
+      GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(level));
+  glBindTexture(GL_TEXTURE_2D, 0);
+}
+
 void Texture2D::Bind() const
 {
   glBindTexture(GL_TEXTURE_2D, this->ID);
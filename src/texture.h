@@ -10,6 +10,7 @@
 #define TEXTURE_H
 
 #include <glad/glad.h>
+#include <glm/glm.hpp>
 
 // Texture2D is able to store and configure a texture in OpenGL.
 // It also hosts utility functions for easy management.
@@ -32,9 +33,33 @@ public:
   // constructor (sets default texture modes)
   Texture2D();
   // generates texture from image data
-  void Generate(unsigned int width, unsigned int height, unsigned char* data);
+  void Generate(unsigned int width,
+                unsigned int height,
+                const unsigned char* data);
+  // sets mipmap level (1 is half the size of the image) from image data;
+  // levels have to be added in order after Generate
+  void AddMipmap(unsigned int level,
+                 unsigned int width,
+                 unsigned int height,
+                 const unsigned char* data);
   // binds the texture as the current active GL_TEXTURE_2D texture object
   void Bind() const;
 };
 
+// TextureRegion refers to a rectangle of a texture, usually one image packed
+// into an atlas. A plain texture converts to a region covering all of it.
+struct TextureRegion
+{
+  TextureRegion() = default;
+  TextureRegion(const Texture2D& texture,
+                glm::vec4 rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f))
+      : Texture(&texture)
+      , Rect(rect)
+  {
+  }
+
+  const Texture2D* Texture = nullptr;
+  glm::vec4 Rect {0.0f, 0.0f, 1.0f, 1.0f};  // <vec2 uv offset, vec2 uv scale>
+};
+
 #endif
\ No newline at end of file
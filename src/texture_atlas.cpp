@@ -0,0 +1,172 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "texture_atlas.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <numeric>
+
+SkylinePacker::SkylinePacker(unsigned int width, unsigned int height)
+    : areaWidth(width)
+    , areaHeight(height)
+    , skyline {Segment {0, 0, width}}
+{
+}
+
+std::optional<AtlasRect> SkylinePacker::Insert(unsigned int width,
+                                               unsigned int height)
+{
+  std::size_t best = this->skyline.size();
+  unsigned int bestY = std::numeric_limits<unsigned int>::max();
+  unsigned int bestWidth = std::numeric_limits<unsigned int>::max();
+  for (std::size_t i = 0; i < this->skyline.size(); ++i) {
+    unsigned int y = 0;
+    if (!this->fits(i, width, height, y))
+      continue;
+    if (y < bestY || (y == bestY && this->skyline[i].Width < bestWidth)) {
+      best = i;
+      bestY = y;
+      bestWidth = this->skyline[i].Width;
+    }
+  }
+  if (best == this->skyline.size())
+    return std::nullopt;
+
+  // the rectangle's top becomes a new segment; cut away what it covers of
+  // the segments to its right
+  const Segment placed {this->skyline[best].X, bestY + height, width};
+  const auto at = static_cast<std::ptrdiff_t>(best);
+  this->skyline.insert(this->skyline.begin() + at, placed);
+  const unsigned int end = placed.X + placed.Width;
+  for (std::size_t i = best + 1; i < this->skyline.size();) {
+    Segment& segment = this->skyline[i];
+    if (segment.X >= end)
+      break;
+    const unsigned int covered = end - segment.X;
+    if (segment.Width > covered) {
+      segment.X += covered;
+      segment.Width -= covered;
+      break;
+    }
+    this->skyline.erase(this->skyline.begin() + static_cast<std::ptrdiff_t>(i));
+  }
+  // neighbours at the same height are one segment
+  for (std::size_t i = 0; i + 1 < this->skyline.size();) {
+    if (this->skyline[i].Y == this->skyline[i + 1].Y) {
+      this->skyline[i].Width += this->skyline[i + 1].Width;
+      this->skyline.erase(this->skyline.begin()
+                          + static_cast<std::ptrdiff_t>(i + 1));
+    } else {
+      ++i;
+    }
+  }
+  return AtlasRect {placed.X, bestY, width, height};
+}
+
+bool SkylinePacker::fits(std::size_t index,
+                         unsigned int width,
+                         unsigned int height,
+                         unsigned int& y) const
+{
+  if (this->skyline[index].X + width > this->areaWidth)
+    return false;
+  // the rectangle rests on the highest segment below it
+  y = 0;
+  unsigned int remaining = width;
+  for (std::size_t i = index; remaining > 0; ++i) {
+    const Segment& segment = this->skyline[i];
+    y = std::max(y, segment.Y);
+    if (y + height > this->areaHeight)
+      return false;
+    remaining -= std::min(remaining, segment.Width);
+  }
+  return true;
+}
+
+std::optional<AtlasLayout> PackAtlas(const std::vector<AtlasRect>& sizes,
+                                     unsigned int padding,
+                                     unsigned int maxSize)
+{
+  // tall images first leaves the flattest skyline
+  std::vector<std::size_t> order(sizes.size());
+  std::iota(order.begin(), order.end(), std::size_t {0});
+  std::sort(order.begin(),
+            order.end(),
+            [&sizes](std::size_t a, std::size_t b)
+            {
+              if (sizes[a].Height != sizes[b].Height)
+                return sizes[a].Height > sizes[b].Height;
+              return sizes[a].Width > sizes[b].Width;
+            });
+
+  AtlasLayout layout;
+  layout.Width = layout.Height = 1;
+  while (layout.Width <= maxSize && layout.Height <= maxSize) {
+    SkylinePacker packer(layout.Width, layout.Height);
+    layout.Rects.assign(sizes.size(), AtlasRect {});
+    bool packed = true;
+    for (std::size_t i : order) {
+      const auto rect = packer.Insert(sizes[i].Width + 2 * padding,
+                                      sizes[i].Height + 2 * padding);
+      if (!rect) {
+        packed = false;
+        break;
+      }
+      layout.Rects[i] = AtlasRect {rect->X + padding,
+                                   rect->Y + padding,
+                                   sizes[i].Width,
+                                   sizes[i].Height};
+    }
+    if (packed)
+      return layout;
+    // grow the shorter side
+    if (layout.Width <= layout.Height)
+      layout.Width *= 2;
+    else
+      layout.Height *= 2;
+  }
+  return std::nullopt;
+}
+
+void CopyIntoAtlas(std::vector<unsigned char>& atlas,
+                   unsigned int atlasWidth,
+                   const unsigned char* image,
+                   const AtlasRect& rect,
+                   unsigned int padding,
+                   unsigned int channels)
+{
+  if (rect.Width == 0 || rect.Height == 0)
+    return;
+  const std::size_t rowBytes = std::size_t {rect.Width} * channels;
+  auto pixel = [&atlas, atlasWidth, channels](unsigned int x, unsigned int y)
+  { return atlas.data() + (std::size_t {y} * atlasWidth + x) * channels; };
+
+  // rows of the image, each extended left and right
+  for (unsigned int row = 0; row < rect.Height; ++row) {
+    const unsigned int y = rect.Y + row;
+    std::memcpy(pixel(rect.X, y), image + row * rowBytes, rowBytes);
+    for (unsigned int i = 1; i <= padding; ++i) {
+      std::memcpy(pixel(rect.X - i, y), pixel(rect.X, y), channels);
+      std::memcpy(pixel(rect.X + rect.Width - 1 + i, y),
+                  pixel(rect.X + rect.Width - 1, y),
+                  channels);
+    }
+  }
+  // then the first and last rows, corners included, up and down
+  const std::size_t paddedBytes =
+      rowBytes + std::size_t {2} * padding * channels;
+  const unsigned int left = rect.X - padding;
+  for (unsigned int i = 1; i <= padding; ++i) {
+    std::memcpy(pixel(left, rect.Y - i), pixel(left, rect.Y), paddedBytes);
+    std::memcpy(pixel(left, rect.Y + rect.Height - 1 + i),
+                pixel(left, rect.Y + rect.Height - 1),
+                paddedBytes);
+  }
+}
@@ -0,0 +1,85 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef TEXTURE_ATLAS_H
+#define TEXTURE_ATLAS_H
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+// A rectangle of an atlas, in pixels
+struct AtlasRect
+{
+  unsigned int X = 0;
+  unsigned int Y = 0;
+  unsigned int Width = 0;
+  unsigned int Height = 0;
+};
+
+// SkylinePacker places rectangles into a fixed-size area with the skyline
+// bottom-left heuristic: it tracks the top edge of the packed rectangles as a
+// list of horizontal segments and puts each new rectangle where its top ends
+// up lowest, preferring narrower segments on ties.
+class SkylinePacker
+{
+public:
+  SkylinePacker(unsigned int width, unsigned int height);
+
+  // Reserves a width x height rectangle; nothing if it doesn't fit anymore
+  std::optional<AtlasRect> Insert(unsigned int width, unsigned int height);
+
+private:
+  struct Segment
+  {
+    unsigned int X;
+    unsigned int Y;
+    unsigned int Width;
+  };
+
+  // Where a rectangle starting at segment index would go; false if it would
+  // stick out of the area
+  bool fits(std::size_t index,
+            unsigned int width,
+            unsigned int height,
+            unsigned int& y) const;
+
+  unsigned int areaWidth;
+  unsigned int areaHeight;
+  std::vector<Segment> skyline;
+};
+
+// Where PackAtlas put each image
+struct AtlasLayout
+{
+  unsigned int Width = 0;
+  unsigned int Height = 0;
+  std::vector<AtlasRect> Rects;  // in the order the sizes were given
+};
+
+// Packs images of the given sizes (width, height) into the smallest power of
+// two atlas up to maxSize square that holds them all. Each image gets padding
+// pixels of gutter on every side, which CopyIntoAtlas fills with its edge
+// pixels so filtering doesn't bleed between neighbours. Nothing if they don't
+// fit.
+std::optional<AtlasLayout> PackAtlas(
+    const std::vector<AtlasRect>& sizes,
+    unsigned int padding,
+    unsigned int maxSize);
+
+// Copies a tightly packed image into its rect of an atlas atlasWidth pixels
+// wide with the same number of channels, and extends its edges into the
+// padding around it
+void CopyIntoAtlas(std::vector<unsigned char>& atlas,
+                   unsigned int atlasWidth,
+                   const unsigned char* image,
+                   const AtlasRect& rect,
+                   unsigned int padding,
+                   unsigned int channels = 4);
+
+#endif
@@ -0,0 +1,250 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#include "texture_cache.h"
+
+#include "hash.h"
+
+#define STB_IMAGE_IMPLEMENTATION
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <system_error>
+#include <utility>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// Bump whenever the cache file layout or the cooking changes
+constexpr std::uint32_t formatVersion = 1;
+constexpr char magic[8] = {'B', 'K', 'T', 'E', 'X', 'T', 'U', 'R'};
+// Pixel data starts at a multiple of this from the start of the file
+constexpr std::size_t dataAlignment = 16;
+// Largest width or height a cache file may claim
+constexpr unsigned int maxSize = 16384;
+
+struct FileHeader
+{
+  char Magic[8];
+  std::uint32_t Version;
+  std::uint32_t LevelCount;
+  std::uint64_t Key;
+};
+
+struct FileLevel
+{
+  std::uint32_t Width;
+  std::uint32_t Height;
+  std::uint64_t Offset;
+};
+
+std::size_t levelBytes(unsigned int width, unsigned int height)
+{
+  return std::size_t {width} * height * 4;
+}
+
+std::size_t dataStart(std::size_t levelCount)
+{
+  const std::size_t headers =
+      sizeof(FileHeader) + levelCount * sizeof(FileLevel);
+  return (headers + dataAlignment - 1) / dataAlignment * dataAlignment;
+}
+
+// Box-filters src down to dst, which is half its size rounded down but at
+// least 1; odd rows and columns repeat their last pixel
+void downsample(const unsigned char* src,
+                unsigned int srcWidth,
+                unsigned int srcHeight,
+                unsigned char* dst,
+                unsigned int dstWidth,
+                unsigned int dstHeight)
+{
+  for (unsigned int y = 0; y < dstHeight; ++y) {
+    const unsigned int y0 = std::min(2 * y, srcHeight - 1);
+    const unsigned int y1 = std::min(2 * y + 1, srcHeight - 1);
+    for (unsigned int x = 0; x < dstWidth; ++x) {
+      const unsigned int x0 = std::min(2 * x, srcWidth - 1);
+      const unsigned int x1 = std::min(2 * x + 1, srcWidth - 1);
+      const unsigned char* p00 = src + (std::size_t {y0} * srcWidth + x0) * 4;
+      const unsigned char* p01 = src + (std::size_t {y0} * srcWidth + x1) * 4;
+      const unsigned char* p10 = src + (std::size_t {y1} * srcWidth + x0) * 4;
+      const unsigned char* p11 = src + (std::size_t {y1} * srcWidth + x1) * 4;
+      unsigned char* out = dst + (std::size_t {y} * dstWidth + x) * 4;
+      for (int c = 0; c < 4; ++c)
+        out[c] = static_cast<unsigned char>(
+            (p00[c] + p01[c] + p10[c] + p11[c] + 2) / 4);
+    }
+  }
+}
+}  // namespace
+
+CookedTexture::CookedTexture(std::vector<unsigned char> pixels,
+                             unsigned int width,
+                             unsigned int height)
+    : levels {Level {width, height, 0}}
+    , owned(std::move(pixels))
+{
+}
+
+const unsigned char* CookedTexture::Pixels(std::size_t level) const
+{
+  const unsigned char* base = this->file.IsOpen()
+      ? this->file.Data() + this->fileOffset
+      : this->owned.data();
+  return base + this->levels[level].Offset;
+}
+
+void CookedTexture::GenerateMipmaps()
+{
+  if (this->levels.size() != 1 || this->IsMapped())
+    return;
+  std::size_t total = this->owned.size();
+  for (Level level = this->levels[0]; level.Width > 1 || level.Height > 1;) {
+    level.Offset = total;
+    level.Width = std::max(level.Width / 2, 1u);
+    level.Height = std::max(level.Height / 2, 1u);
+    total += levelBytes(level.Width, level.Height);
+    this->levels.push_back(level);
+  }
+  this->owned.resize(total);
+  for (std::size_t i = 1; i < this->levels.size(); ++i) {
+    const Level& above = this->levels[i - 1];
+    const Level& level = this->levels[i];
+    downsample(this->owned.data() + above.Offset,
+               above.Width,
+               above.Height,
+               this->owned.data() + level.Offset,
+               level.Width,
+               level.Height);
+  }
+}
+
+std::optional<CookedTexture> DecodeTexture(const fs::path& file)
+{
+  int width, height, nrChannels;
+  std::unique_ptr<unsigned char, void (*)(void*)> data(
+      stbi_load(file.string().c_str(), &width, &height, &nrChannels, 4),
+      stbi_image_free);
+  if (!data)
+    return std::nullopt;
+  const auto w = static_cast<unsigned int>(width);
+  const auto h = static_cast<unsigned int>(height);
+  std::vector<unsigned char> pixels(data.get(),
+                                    data.get() + levelBytes(w, h));
+  return CookedTexture(std::move(pixels), w, h);
+}
+
+std::optional<AtlasRect> ReadTextureSize(const fs::path& file)
+{
+  int width, height, nrChannels;
+  if (!stbi_info(file.string().c_str(), &width, &height, &nrChannels))
+    return std::nullopt;
+  return AtlasRect {0,
+                    0,
+                    static_cast<unsigned int>(width),
+                    static_cast<unsigned int>(height)};
+}
+
+std::uint64_t CookedTextureKey(const std::vector<fs::path>& sources,
+                               std::uint64_t settings)
+{
+  std::uint64_t hash = MixBits(settings ^ formatVersion);
+  for (const fs::path& source : sources) {
+    // a missing file still changes the key, so the lists [a, missing] and
+    // [missing, a] differ
+    const MappedFile file(source);
+    hash = HashBytes(file.Data(), file.Size(), MixBits(hash + file.IsOpen()));
+  }
+  return hash;
+}
+
+bool SaveCookedTexture(const CookedTexture& texture,
+                       std::uint64_t key,
+                       const fs::path& path)
+{
+  const auto& levels = texture.Levels();
+  if (levels.empty())
+    return false;
+  std::error_code error;
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path(), error);
+  // write next to the target and rename, so a crash never leaves a
+  // half-written cache behind
+  fs::path temporary = path;
+  temporary += ".tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+    if (!out)
+      return false;
+    FileHeader header {};
+    std::memcpy(header.Magic, magic, sizeof(magic));
+    header.Version = formatVersion;
+    header.LevelCount = static_cast<std::uint32_t>(levels.size());
+    header.Key = key;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const CookedTexture::Level& level : levels) {
+      const FileLevel entry {level.Width, level.Height, level.Offset};
+      out.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    }
+    const std::size_t written =
+        sizeof(FileHeader) + levels.size() * sizeof(FileLevel);
+    const std::vector<char> padding(dataStart(levels.size()) - written, 0);
+    out.write(padding.data(), static_cast<std::streamsize>(padding.size()));
+    // the levels are stored back to back in order
+    const CookedTexture::Level& last = levels.back();
+    out.write(reinterpret_cast<const char*>(texture.Pixels()),
+              static_cast<std::streamsize>(
+                  last.Offset + levelBytes(last.Width, last.Height)));
+    if (!out)
+      return false;
+  }
+  fs::rename(temporary, path, error);
+  return !error;
+}
+
+std::optional<CookedTexture> LoadCookedTexture(std::uint64_t key,
+                                               const fs::path& path)
+{
+  MappedFile file(path);
+  FileHeader header {};
+  if (!file.IsOpen() || file.Size() < sizeof(header))
+    return std::nullopt;
+  std::memcpy(&header, file.Data(), sizeof(header));
+  if (std::memcmp(header.Magic, magic, sizeof(magic)) != 0
+      || header.Version != formatVersion || header.Key != key
+      || header.LevelCount == 0 || header.LevelCount > 32)
+    return std::nullopt;
+  const std::size_t start = dataStart(header.LevelCount);
+  if (file.Size() < start)
+    return std::nullopt;
+
+  CookedTexture texture;
+  for (std::size_t i = 0; i < header.LevelCount; ++i) {
+    FileLevel entry {};
+    std::memcpy(&entry,
+                file.Data() + sizeof(header) + i * sizeof(entry),
+                sizeof(entry));
+    // refuse sizes no cook would have produced and levels beyond the end of
+    // the file, instead of reading past the mapping
+    if (entry.Width == 0 || entry.Height == 0 || entry.Width > maxSize
+        || entry.Height > maxSize
+        || entry.Offset > file.Size() - start
+        || levelBytes(entry.Width, entry.Height)
+            > file.Size() - start - entry.Offset)
+      return std::nullopt;
+    texture.levels.push_back(CookedTexture::Level {
+        entry.Width, entry.Height, static_cast<std::size_t>(entry.Offset)});
+  }
+  texture.file = std::move(file);
+  texture.fileOffset = start;
+  return texture;
+}
@@ -0,0 +1,86 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+#include "mapped_file.h"
+#include "texture_atlas.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// RGBA pixels ready to be uploaded, with an optional chain of mipmaps. The
+// pixels are either held in memory or mapped straight from a cooked cache
+// file, in which case nothing is decoded or copied before the upload.
+class CookedTexture
+{
+public:
+  // A mip level; level 0 is the full image, each next one half as large
+  struct Level
+  {
+    unsigned int Width = 0;
+    unsigned int Height = 0;
+    std::size_t Offset = 0;  // of the first pixel, from Pixels(0)
+  };
+
+  CookedTexture() = default;
+  // Takes width x height RGBA pixels, rows tightly packed
+  CookedTexture(std::vector<unsigned char> pixels,
+                unsigned int width,
+                unsigned int height);
+
+  unsigned int Width() const { return levels.empty() ? 0 : levels[0].Width; }
+  unsigned int Height() const { return levels.empty() ? 0 : levels[0].Height; }
+  const std::vector<Level>& Levels() const { return levels; }
+  // The pixels of a mip level, 4 bytes each, rows tightly packed
+  const unsigned char* Pixels(std::size_t level = 0) const;
+  // Whether the pixels are mapped from a cache file
+  bool IsMapped() const { return file.IsOpen(); }
+
+  // Adds mip levels down to 1x1, each pixel the average of 2x2 pixels of the
+  // level above. Does nothing if the levels exist already.
+  void GenerateMipmaps();
+
+private:
+  friend std::optional<CookedTexture> LoadCookedTexture(
+      std::uint64_t key, const std::filesystem::path& path);
+
+  std::vector<Level> levels;
+  // the pixels of all levels, unless they are mapped
+  std::vector<unsigned char> owned;
+  MappedFile file;
+  std::size_t fileOffset = 0;  // of the first pixel in file
+};
+
+// Decodes a PNG or JPEG file into RGBA pixels, without mipmaps; nothing if
+// the file can't be read
+std::optional<CookedTexture> DecodeTexture(const std::filesystem::path& file);
+// Reads the size of an image from its header, without decoding it
+std::optional<AtlasRect> ReadTextureSize(const std::filesystem::path& file);
+
+// Identifies a texture cooked from the sources as they are now: hashes their
+// contents, the cache format and settings, which stands for whatever else the
+// cooked pixels depend on
+std::uint64_t CookedTextureKey(
+    const std::vector<std::filesystem::path>& sources,
+    std::uint64_t settings = 0);
+
+// Writes a texture to a cache file; false on failure
+bool SaveCookedTexture(const CookedTexture& texture,
+                       std::uint64_t key,
+                       const std::filesystem::path& path);
+// Maps a texture from a cache file; nothing if the file is missing, damaged
+// or was saved under another key
+std::optional<CookedTexture> LoadCookedTexture(
+    std::uint64_t key, const std::filesystem::path& path);
+
+#endif
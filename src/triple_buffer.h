@@ -0,0 +1,63 @@
+/*******************************************************************
+** This code is part of Breakout.
+**
+** Breakout is free software: you can redistribute it and/or modify
+** it under the terms of the CC BY 4.0 license as published by
+** Creative Commons, either version 4 of the License, or (at your
+** option) any later version.
+******************************************************************/
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+#include <array>
+#include <atomic>
+
+// TripleBuffer hands the latest value from one writer thread to one reader
+// thread without locks. The writer fills Back() and publishes it; the reader
+// picks up the newest published value with Fetch() and reads Front(). Neither
+// side ever waits for the other: values the reader didn't get to are simply
+// replaced. The slots are reused, so values holding vectors stop allocating
+// once their capacity has grown.
+template<typename T>
+class TripleBuffer
+{
+public:
+  // Writer: the slot to fill next
+  T& Back() { return this->slots[this->back]; }
+  // Writer: makes Back() the newest value and hands out another slot
+  void Publish()
+  {
+    const unsigned int previous = this->middle.exchange(
+        this->back | fresh, std::memory_order_acq_rel);
+    this->back = previous & index;
+  }
+
+  // Reader: moves the newest value to Front(); false if nothing was
+  // published since the last call
+  bool Fetch()
+  {
+    if ((this->middle.load(std::memory_order_relaxed) & fresh) == 0)
+      return false;
+    const unsigned int previous =
+        this->middle.exchange(this->front, std::memory_order_acq_rel);
+    this->front = previous & index;
+    return true;
+  }
+  // Reader: the value fetched last
+  const T& Front() const { return this->slots[this->front]; }
+
+private:
+  // the middle slot's index, with a flag set while it holds a value the
+  // reader hasn't fetched yet
+  static constexpr unsigned int index = 3u;
+  static constexpr unsigned int fresh = 4u;
+
+  std::array<T, 3> slots {};
+  // each index is only touched by its own thread; they are kept on separate
+  // cache lines so the threads don't slow each other down
+  alignas(64) unsigned int back = 0;
+  alignas(64) std::atomic<unsigned int> middle {1};
+  alignas(64) unsigned int front = 2;
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "asset_loader.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("assets are finished on the polling thread", "[threads][assets]")
+{
+  AssetLoader loader(3);
+  REQUIRE(loader.Threads() == 3);
+  const auto main = std::this_thread::get_id();
+  std::vector<int> finished;
+  std::vector<AssetHandle> handles;
+  for (int i = 0; i < 20; ++i)
+    handles.push_back(loader.Load(
+        "asset " + std::to_string(i),
+        [i, main]
+        {
+          // the work runs on a worker
+          return std::this_thread::get_id() == main ? -1 : i;
+        },
+        [&finished, main](int value)
+        {
+          if (std::this_thread::get_id() == main)
+            finished.push_back(value);
+        }));
+  // nothing is finished before the loader is polled
+  REQUIRE(finished.empty());
+
+  handles[7].Wait();
+  REQUIRE(handles[7].Ready());
+  loader.WaitAll();
+  REQUIRE(finished.size() == 20);
+  for (int value : finished)
+    REQUIRE(value >= 0);
+  for (const AssetHandle& handle : handles)
+    REQUIRE(handle.Ready());
+
+  REQUIRE(loader.Timings().size() == 20);
+  REQUIRE(loader.Timings().front().Name.starts_with("asset "));
+}
+
+TEST_CASE("assets load side by side", "[threads][assets]")
+{
+  constexpr int count = 4;
+  AssetLoader loader(count);
+  std::atomic<int> started {0};
+  int together = 0;
+  for (int i = 0; i < count; ++i)
+    loader.Load(
+        "asset",
+        [&started]
+        {
+          // wait until every job is running at once
+          ++started;
+          const auto deadline =
+              std::chrono::steady_clock::now() + std::chrono::seconds(10);
+          while (started.load() < count
+                 && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::yield();
+          return started.load() == count;
+        },
+        [&together](bool all)
+        {
+          if (all)
+            ++together;
+        });
+  loader.WaitAll();
+  REQUIRE(together == count);
+}
+
+TEST_CASE("a failed asset reports its error", "[threads][assets]")
+{
+  AssetLoader loader(2);
+  bool finished = false;
+  int others = 0;
+  const AssetHandle broken = loader.Load(
+      "broken",
+      []() -> int { throw std::runtime_error {"no such file"}; },
+      [&finished](int) { finished = true; });
+  for (int i = 0; i < 5; ++i)
+    loader.Load(
+        "fine", [] { return 1; }, [&others](int value) { others += value; });
+
+  REQUIRE_THROWS_AS(broken.Wait(), std::runtime_error);
+  REQUIRE(broken.Ready());
+
+  SECTION("the others still load")
+  {
+    REQUIRE_THROWS_WITH(loader.WaitAll(), "no such file");
+    REQUIRE(others == 5);
+    REQUIRE_FALSE(finished);
+    // the error is reported once
+    REQUIRE_NOTHROW(loader.WaitAll());
+  }
+
+  SECTION("a failing finish fails the asset")
+  {
+    const AssetHandle upload = loader.Load(
+        "upload",
+        [] { return 1; },
+        [](int) { throw std::runtime_error {"out of memory"}; });
+    REQUIRE_THROWS_WITH(upload.Wait(), "out of memory");
+  }
+}
@@ -0,0 +1,68 @@
+#include "collision.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+namespace
+{
+const glm::vec2 boxMin(100.0f, 100.0f);
+const glm::vec2 boxMax(200.0f, 150.0f);
+constexpr float radius = 10.0f;
+
+std::optional<SweepHit> sweep(glm::vec2 center, glm::vec2 motion)
+{
+  return SweepCircleAabb(center, radius, motion, boxMin, boxMax);
+}
+}  // namespace
+
+TEST_CASE("swept circle hits the face it moves into", "[collision]")
+{
+  // from below, moving up far past the box
+  auto hit = sweep(glm::vec2(150.0f, 200.0f), glm::vec2(0.0f, -1000.0f));
+  REQUIRE(hit);
+  // the circle touches the bottom face after 40 of the 1000 units
+  REQUIRE(hit->Time == Catch::Approx(0.04f));
+  REQUIRE(hit->Normal.x == Catch::Approx(0.0f));
+  REQUIRE(hit->Normal.y == Catch::Approx(1.0f));
+
+  // from the left
+  hit = sweep(glm::vec2(0.0f, 120.0f), glm::vec2(180.0f, 0.0f));
+  REQUIRE(hit);
+  REQUIRE(hit->Time == Catch::Approx(0.5f));
+  REQUIRE(hit->Normal.x == Catch::Approx(-1.0f));
+}
+
+TEST_CASE("swept circle rounds the corners of the box", "[collision]")
+{
+  // aimed diagonally at the top-left corner
+  const auto hit = sweep(glm::vec2(50.0f), glm::vec2(100.0f));
+  REQUIRE(hit);
+  REQUIRE(hit->Normal.x == Catch::Approx(-0.70710678f));
+  REQUIRE(hit->Normal.y == Catch::Approx(-0.70710678f));
+  const glm::vec2 contact = glm::vec2(50.0f) + 100.0f * hit->Time;
+  REQUIRE(glm::length(contact - boxMin) == Catch::Approx(radius));
+
+  // crossing the corner of the grown box, but outside the rounding
+  REQUIRE_FALSE(sweep(glm::vec2(50.0f, 132.0f), glm::vec2(100.0f, -100.0f)));
+}
+
+TEST_CASE("swept circle misses what it doesn't reach", "[collision]")
+{
+  // stops short
+  REQUIRE_FALSE(sweep(glm::vec2(150.0f, 200.0f), glm::vec2(0.0f, -30.0f)));
+  // moves away
+  REQUIRE_FALSE(sweep(glm::vec2(150.0f, 200.0f), glm::vec2(0.0f, 30.0f)));
+  // slides along a face it touches
+  REQUIRE_FALSE(sweep(glm::vec2(150.0f, 160.0f), glm::vec2(100.0f, 0.0f)));
+}
+
+TEST_CASE("overlapping circles only hit while moving in", "[collision]")
+{
+  const glm::vec2 inside(150.0f, 155.0f);
+  const auto hit = sweep(inside, glm::vec2(0.0f, -5.0f));
+  REQUIRE(hit);
+  REQUIRE(hit->Time == Catch::Approx(0.0f));
+  REQUIRE(hit->Normal.y == Catch::Approx(1.0f));
+
+  REQUIRE_FALSE(sweep(inside, glm::vec2(0.0f, 5.0f)));
+}
@@ -0,0 +1,74 @@
+#include "file_watcher.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+using namespace std::chrono_literals;
+
+constexpr auto debounce = 100ms;
+
+void write(const fs::path& file, const std::string& text)
+{
+  std::ofstream(file) << text;
+}
+}  // namespace
+
+TEST_CASE("changed files are reported once they settle", "[reload]")
+{
+  if (!FileWatcher::IsSupported()) {
+    WARN("Files can't be watched on this platform");
+    return;
+  }
+  const fs::path dir = fs::temp_directory_path() / "breakout_watch_test";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  FileWatcher watcher(debounce);
+  REQUIRE(watcher.Watch(dir));
+  REQUIRE_FALSE(watcher.Watch(dir / "missing"));
+
+  const auto start = FileWatcher::Clock::now();
+  REQUIRE(watcher.Poll(start).empty());
+
+  SECTION("a written file")
+  {
+    write(dir / "level.lvl", "1 1 1");
+    REQUIRE(watcher.Poll(start).empty());
+    REQUIRE(watcher.Poll(start + debounce)
+            == std::vector<fs::path> {dir / "level.lvl"});
+    REQUIRE(watcher.Poll(start + 2 * debounce).empty());
+  }
+
+  SECTION("writes in a row are reported as one change")
+  {
+    write(dir / "sprite.frag", "first");
+    REQUIRE(watcher.Poll(start).empty());
+    write(dir / "sprite.frag", "second");
+    // the second write restarts the wait
+    REQUIRE(watcher.Poll(start + 80ms).empty());
+    REQUIRE(watcher.Poll(start + 150ms).empty());
+    REQUIRE(watcher.Poll(start + 180ms)
+            == std::vector<fs::path> {dir / "sprite.frag"});
+  }
+
+  SECTION("a file renamed into the directory")
+  {
+    // how editors save: write a temporary file, then replace the original
+    const fs::path temporary = fs::temp_directory_path() / "breakout.tmp";
+    write(temporary, "saved");
+    fs::rename(temporary, dir / "block.png");
+    REQUIRE(watcher.Poll(start).empty());
+    REQUIRE(watcher.Poll(start + debounce)
+            == std::vector<fs::path> {dir / "block.png"});
+  }
+
+  fs::remove_all(dir);
+}
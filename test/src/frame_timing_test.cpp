@@ -0,0 +1,59 @@
+#include "frame_timing.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+TEST_CASE("fixed timestep runs whole ticks and carries the rest", "[timing]")
+{
+  FixedTimestep timestep(100.0, 8);
+  REQUIRE(timestep.TickSeconds() == Catch::Approx(0.01f));
+
+  // 25 ms is two ticks with half a tick left over
+  REQUIRE(timestep.Advance(0.025) == 2);
+  REQUIRE(timestep.Alpha() == Catch::Approx(0.5f));
+  // the leftover completes the next tick
+  REQUIRE(timestep.Advance(0.005) == 1);
+  REQUIRE(timestep.Alpha() == Catch::Approx(0.0f).margin(1e-6));
+  // frames shorter than a tick run none
+  REQUIRE(timestep.Advance(0.004) == 0);
+  REQUIRE(timestep.Alpha() == Catch::Approx(0.4f));
+  REQUIRE(timestep.DroppedTicks() == 0);
+}
+
+TEST_CASE("fixed timestep drops what exceeds the tick cap", "[timing]")
+{
+  FixedTimestep timestep(100.0, 4);
+  // a one second stall: only 4 ticks run, the other 96 are dropped
+  REQUIRE(timestep.Advance(1.0) == 4);
+  REQUIRE(timestep.DroppedTicks() == 96);
+  REQUIRE(timestep.Alpha() < 1.0f);
+  // and the next frame isn't spent catching up
+  REQUIRE(timestep.Advance(0.01) == 1);
+}
+
+TEST_CASE("frame stats summarize a window", "[timing]")
+{
+  FrameStats stats;
+  stats.AddFrame(0.010, 0.002, 1);
+  stats.AddFrame(0.020, 0.004, 2);
+  stats.AddFrame(0.030, 0.006, 3);
+
+  REQUIRE(stats.Frames() == 3);
+  REQUIRE(stats.Ticks() == 6);
+  REQUIRE(stats.Elapsed() == Catch::Approx(0.06));
+  REQUIRE(stats.MeanFrameMs() == Catch::Approx(20.0));
+  // population variance of 10, 20, 30 ms
+  REQUIRE(stats.FrameVarianceMs2() == Catch::Approx(200.0 / 3.0));
+  REQUIRE(stats.MaxFrameMs() == Catch::Approx(30.0));
+  REQUIRE(stats.SimLoad() == Catch::Approx(0.2));
+
+  std::ostringstream report;
+  stats.Report(report);
+  REQUIRE(report.str().find("50 fps") != std::string::npos);
+
+  stats.Reset();
+  REQUIRE(stats.Frames() == 0);
+  REQUIRE(stats.MeanFrameMs() == Catch::Approx(0.0));
+}
@@ -0,0 +1,242 @@
+#include "game_level.h"
+#include "game_object.h"
+#include "simulation.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace
+{
+// A columns x rows level, every brick of the given tile code
+std::vector<std::vector<unsigned int>> tiles(unsigned int columns,
+                                             unsigned int rows,
+                                             unsigned int code = 2)
+{
+  return std::vector<std::vector<unsigned int>>(
+      rows, std::vector<unsigned int>(columns, code));
+}
+
+bool overlaps(glm::vec2 position, glm::vec2 size, glm::vec2 min, glm::vec2 max)
+{
+  return position.x <= max.x && position.x + size.x >= min.x
+      && position.y <= max.y && position.y + size.y >= min.y;
+}
+}  // namespace
+
+TEST_CASE("brick grid finds the bricks in a box", "[level]")
+{
+  GameLevel level;
+  // leave some holes in the grid
+  auto data = tiles(20, 10);
+  data[3][4] = 0;
+  data[5][6] = 1;
+  level.Load(data, 800, 300);
+  REQUIRE(level.Bricks.Count() == 199);
+
+  const glm::vec2 min(150.0f, 80.0f);
+  const glm::vec2 max(290.0f, 190.0f);
+  std::vector<unsigned int> found;
+  level.ForEachBrickIn(
+      min, max, [&found](unsigned int brick) { found.push_back(brick); });
+
+  std::vector<unsigned int> expected;
+  for (unsigned int i = 0; i < level.Bricks.Count(); ++i)
+    if (overlaps(level.Bricks.Positions[i], level.Bricks.Size, min, max))
+      expected.push_back(i);
+  REQUIRE(found == expected);
+
+  SECTION("destroyed bricks are skipped")
+  {
+    level.Destroy(expected.front());
+    unsigned int count = 0;
+    level.ForEachBrickIn(min, max, [&count](unsigned int) { ++count; });
+    REQUIRE(count == expected.size() - 1);
+  }
+
+  SECTION("boxes outside the level find nothing")
+  {
+    unsigned int count = 0;
+    auto counter = [&count](unsigned int) { ++count; };
+    level.ForEachBrickIn(glm::vec2(-50.0f), glm::vec2(-1.0f), counter);
+    level.ForEachBrickIn(glm::vec2(0.0f, 400.0f), glm::vec2(800.0f), counter);
+    REQUIRE(count == 0);
+  }
+}
+
+TEST_CASE("a reset brings destroyed bricks back", "[level]")
+{
+  GameLevel level;
+  auto data = tiles(70, 3);
+  data[0][0] = 1;
+  level.Load(data, 800, 300);
+  const std::size_t count = level.Bricks.Count();
+  REQUIRE(level.Bricks.IsSolid(0));
+  REQUIRE(level.RemainingBricks() == count - 1);
+
+  // solid bricks don't keep a level from being completed
+  for (std::size_t i = 1; i < count; ++i)
+    level.Destroy(i);
+  REQUIRE(level.IsCompleted());
+  REQUIRE(level.AliveBricks().Count() == 1);
+
+  level.Reset();
+  REQUIRE_FALSE(level.IsCompleted());
+  REQUIRE(level.AliveBricks().Count() == count);
+  REQUIRE(level.RemainingBricks() == count - 1);
+  REQUIRE(level.Bricks.Count() == count);
+}
+
+TEST_CASE("the remaining bricks are counted as they are destroyed", "[level]")
+{
+  GameLevel level;
+  auto data = tiles(10, 10);
+  data[0][0] = data[9][9] = 1;
+  level.Load(data, 800, 300);
+  REQUIRE(level.RemainingBricks() == 98);
+
+  SECTION("a brick is only counted once")
+  {
+    level.Destroy(1);
+    level.Destroy(1);
+    REQUIRE(level.RemainingBricks() == 97);
+    REQUIRE(level.CountRemainingBricks() == 97);
+  }
+
+  SECTION("solid bricks don't count")
+  {
+    level.Destroy(0);
+    level.Destroy(99);
+    REQUIRE(level.RemainingBricks() == 98);
+    for (std::size_t i = 1; i < 99; ++i)
+      level.Destroy(i);
+    REQUIRE(level.RemainingBricks() == 0);
+    REQUIRE(level.IsCompleted());
+  }
+
+  SECTION("a reset counts every brick again")
+  {
+    for (std::size_t i = 0; i < 100; i += 3)
+      level.Destroy(i);
+    REQUIRE(level.RemainingBricks() == level.CountRemainingBricks());
+    level.Reset();
+    REQUIRE(level.RemainingBricks() == 98);
+    REQUIRE(level.CountRemainingBricks() == 98);
+  }
+
+  SECTION("levels without breakable bricks are completed")
+  {
+    level.Load(tiles(4, 2, 1), 800, 300);
+    REQUIRE(level.IsCompleted());
+    level.Load(tiles(0, 0), 800, 300);
+    REQUIRE(level.IsCompleted());
+  }
+}
+
+TEST_CASE("collision cost by level size", "[.benchmark][level]")
+{
+  constexpr float dt = 1.0f / 60.0f;
+  for (unsigned int columns : {10u, 100u, 300u}) {
+    Simulation sim(800, 600);
+    sim.Init();
+    sim.Start();
+    sim.Levels[sim.Level].Load(tiles(columns, columns / 2), 800, 300);
+
+    // the ball flies between the walls below the bricks, so every step only
+    // pays for the broadphase
+    sim.Ball.Stuck = false;
+    sim.Ball.Position = glm::vec2(400.0f, 400.0f);
+    sim.Ball.Velocity = glm::vec2(300.0f, 0.0f);
+
+    const auto bricks = sim.Levels[sim.Level].Bricks.Count();
+    BENCHMARK(std::to_string(bricks) + " bricks, 1000 steps")
+    {
+      for (int i = 0; i < 1000; ++i)
+        sim.Step(dt, SimInput {});
+      return sim.Ball.Position;
+    };
+  }
+}
+
+TEST_CASE("level reset latency", "[.benchmark][level]")
+{
+  for (unsigned int columns : {16u, 128u, 1024u}) {
+    GameLevel level;
+    level.Load(tiles(columns, columns), 800, 300);
+    const std::string size = std::to_string(level.Bricks.Count()) + " bricks";
+
+    // what a reset used to cost: loading the level again
+    auto data = tiles(columns, columns);
+    BENCHMARK("load, " + size)
+    {
+      level.Load(data, 800, 300);
+    };
+
+    BENCHMARK("reset, " + size)
+    {
+      level.Destroy(level.Bricks.Count() / 2);
+      level.Reset();
+      return level.AliveBricks().Words().front();
+    };
+  }
+}
+
+TEST_CASE("brick storage cost by level size", "[.benchmark][level]")
+{
+  // bytes per brick: the GameObject the level used to keep for every brick
+  // against its position, color and type; the solid and alive bits add a
+  // quarter of a byte
+  const std::string aos = "AoS " + std::to_string(sizeof(GameObject)) + "B";
+  const std::string soa = "SoA " + std::to_string(sizeof(glm::vec2) + 2) + "B";
+  for (unsigned int columns : {16u, 128u, 1024u}) {
+    GameLevel level;
+    level.Load(tiles(columns, columns), 800, 300);
+    const BrickLayout& bricks = level.Bricks;
+    std::vector<GameObject> legacy;
+    for (std::size_t i = 0; i < bricks.Count(); ++i)
+      legacy.emplace_back(bricks.Positions[i], bricks.Size, bricks.Color(i));
+    const std::string size = std::to_string(bricks.Count()) + " bricks";
+
+    // what collision and drawing read of every standing brick
+    BENCHMARK(aos + " boxes, " + size)
+    {
+      glm::vec2 sum(0.0f);
+      for (const GameObject& brick : legacy)
+        if (!brick.Destroyed)
+          sum += brick.Position + brick.Size;
+      return sum;
+    };
+    BENCHMARK(soa + " boxes, " + size)
+    {
+      glm::vec2 sum(0.0f);
+      for (std::size_t i = 0; i < bricks.Count(); ++i)
+        if (level.AliveBricks().Test(i))
+          sum += bricks.Positions[i] + bricks.Size;
+      return sum;
+    };
+
+    // the win check with one brick left at the very end
+    for (std::size_t i = 0; i + 1 < bricks.Count(); ++i) {
+      legacy[i].Destroyed = true;
+      level.Destroy(i);
+    }
+    BENCHMARK(aos + " win scan, " + size)
+    {
+      return std::none_of(legacy.begin(),
+                          legacy.end(),
+                          [](const GameObject& brick)
+                          { return !brick.IsSolid && !brick.Destroyed; });
+    };
+    BENCHMARK(soa + " win popcount, " + size)
+    {
+      return level.CountRemainingBricks() == 0;
+    };
+    BENCHMARK("win counter, " + size)
+    {
+      return level.RemainingBricks() == 0;
+    };
+  }
+}
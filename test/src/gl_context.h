@@ -0,0 +1,51 @@
+#pragma once
+
+// clang-format off
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+// clang-format on
+
+// Creates a hidden window with an OpenGL 3.3 core context for tests that
+// need to talk to a driver. On machines without a display the context is
+// simply unavailable and such tests should bail out early. CI forces Mesa's
+// llvmpipe through LIBGL_ALWAYS_SOFTWARE, see test/CMakeLists.txt.
+class HeadlessContext
+{
+public:
+  HeadlessContext()
+  {
+    if (!glfwInit())
+      return;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    m_window = glfwCreateWindow(64, 64, "Breakout_test", nullptr, nullptr);
+    if (m_window == nullptr)
+      return;
+    glfwMakeContextCurrent(m_window);
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(glfwGetProcAddress)))
+    {
+      glfwDestroyWindow(m_window);
+      m_window = nullptr;
+    }
+  }
+
+  HeadlessContext(const HeadlessContext&) = delete;
+  HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+  ~HeadlessContext()
+  {
+    if (m_window != nullptr)
+      glfwDestroyWindow(m_window);
+    glfwTerminate();
+  }
+
+  explicit operator bool() const { return m_window != nullptr; }
+
+private:
+  GLFWwindow* m_window = nullptr;
+};
@@ -0,0 +1,144 @@
+#include "glyph_atlas.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+
+namespace
+{
+const std::string font = "fonts/OCRAEXT.TTF";
+
+bool sameBits(glm::vec4 a, glm::vec4 b)
+{
+  return std::bit_cast<std::uint32_t>(a.x) == std::bit_cast<std::uint32_t>(b.x)
+      && std::bit_cast<std::uint32_t>(a.y) == std::bit_cast<std::uint32_t>(b.y)
+      && std::bit_cast<std::uint32_t>(a.z) == std::bit_cast<std::uint32_t>(b.z)
+      && std::bit_cast<std::uint32_t>(a.w) == std::bit_cast<std::uint32_t>(b.w);
+}
+
+bool sameCharacters(const GlyphAtlas& a, const GlyphAtlas& b)
+{
+  for (std::size_t c = 0; c < a.Characters.size(); ++c) {
+    const Character& x = a.Characters[c];
+    const Character& y = b.Characters[c];
+    if (!sameBits(x.TexRect, y.TexRect) || x.Size != y.Size
+        || x.Bearing != y.Bearing || x.Advance != y.Advance)
+      return false;
+  }
+  return true;
+}
+
+// The atlas value at the center of a glyph's rect
+unsigned char centerOf(const GlyphAtlas& atlas, char c)
+{
+  const Character& ch = atlas.Characters[static_cast<unsigned char>(c)];
+  const auto x = static_cast<unsigned int>(
+      (ch.TexRect.x + ch.TexRect.z / 2.0f) * static_cast<float>(atlas.Width));
+  const auto y = static_cast<unsigned int>(
+      (ch.TexRect.y + ch.TexRect.w / 2.0f) * static_cast<float>(atlas.Height));
+  return atlas.Pixels[std::size_t {y} * atlas.Width + x];
+}
+
+// The atlas value at the top left corner of a glyph's rect
+unsigned char cornerOf(const GlyphAtlas& atlas, char c)
+{
+  const Character& ch = atlas.Characters[static_cast<unsigned char>(c)];
+  const auto x = static_cast<unsigned int>(ch.TexRect.x
+                                           * static_cast<float>(atlas.Width));
+  const auto y = static_cast<unsigned int>(ch.TexRect.y
+                                           * static_cast<float>(atlas.Height));
+  return atlas.Pixels[std::size_t {y} * atlas.Width + x];
+}
+}  // namespace
+
+TEST_CASE("glyphs render the same on any number of threads", "[font]")
+{
+  for (GlyphMode mode : {GlyphMode::Bitmap, GlyphMode::SDF}) {
+    const auto serial = BuildGlyphAtlas(font, 24, mode, 1);
+    const auto parallel = BuildGlyphAtlas(font, 24, mode, 4);
+    REQUIRE(serial);
+    REQUIRE(parallel);
+    REQUIRE(serial->Width == parallel->Width);
+    REQUIRE(serial->Height == parallel->Height);
+    REQUIRE(serial->Pixels == parallel->Pixels);
+    REQUIRE(sameCharacters(*serial, *parallel));
+  }
+}
+
+TEST_CASE("SDF glyphs hold distances around the outline", "[font]")
+{
+  const auto atlas = BuildGlyphAtlas(font, 24, GlyphMode::SDF);
+  REQUIRE(atlas);
+  // the center of an 'o' is outside the outline, the bar of a '-' inside;
+  // both sit in a margin of plain outside
+  CHECK(centerOf(*atlas, 'o') < 128);
+  CHECK(centerOf(*atlas, '-') > 128);
+  CHECK(cornerOf(*atlas, '-') < 128);
+  // the margin makes SDF glyphs larger than their bitmaps
+  const auto bitmaps = BuildGlyphAtlas(font, 24, GlyphMode::Bitmap);
+  REQUIRE(bitmaps);
+  constexpr int margin = 2 * static_cast<int>(glyphSdfSpread);
+  CHECK(atlas->Characters['H'].Size.x
+        == bitmaps->Characters['H'].Size.x + margin);
+}
+
+TEST_CASE("glyph atlases are cached on disk", "[font]")
+{
+  const auto path =
+      std::filesystem::temp_directory_path() / "breakout_glyphs_test.glyphs";
+  const auto atlas = BuildGlyphAtlas(font, 24, GlyphMode::SDF);
+  REQUIRE(atlas);
+  const auto key = GlyphAtlasKey(font, 24, GlyphMode::SDF);
+  REQUIRE(SaveGlyphAtlas(*atlas, key, path));
+
+  const auto loaded = LoadGlyphAtlas(key, path);
+  REQUIRE(loaded);
+  CHECK(loaded->Width == atlas->Width);
+  CHECK(loaded->Height == atlas->Height);
+  CHECK(loaded->Pixels == atlas->Pixels);
+  CHECK(sameCharacters(*loaded, *atlas));
+
+  SECTION("another size or mode doesn't match")
+  {
+    CHECK(GlyphAtlasKey(font, 32, GlyphMode::SDF) != key);
+    CHECK(GlyphAtlasKey(font, 24, GlyphMode::Bitmap) != key);
+    CHECK_FALSE(LoadGlyphAtlas(GlyphAtlasKey(font, 32, GlyphMode::SDF), path));
+  }
+
+  SECTION("a truncated file is rejected")
+  {
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) / 2);
+    CHECK_FALSE(LoadGlyphAtlas(key, path));
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("glyph atlas build time", "[.benchmark][font]")
+{
+  const auto path =
+      std::filesystem::temp_directory_path() / "breakout_glyphs_bench.glyphs";
+  const auto key = GlyphAtlasKey(font, 24, GlyphMode::SDF);
+  SaveGlyphAtlas(*BuildGlyphAtlas(font, 24, GlyphMode::SDF), key, path);
+
+  BENCHMARK("bitmap glyphs")
+  {
+    return BuildGlyphAtlas(font, 24, GlyphMode::Bitmap, 1);
+  };
+  BENCHMARK("SDF glyphs, 1 thread")
+  {
+    return BuildGlyphAtlas(font, 24, GlyphMode::SDF, 1);
+  };
+  BENCHMARK("SDF glyphs, all cores")
+  {
+    return BuildGlyphAtlas(font, 24, GlyphMode::SDF);
+  };
+  BENCHMARK("SDF glyphs from the cache")
+  {
+    return LoadGlyphAtlas(key, path);
+  };
+  std::filesystem::remove(path);
+}
@@ -0,0 +1,140 @@
+#include "game_level.h"
+#include "level_file.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// A columns x rows level of breakable bricks with a solid one here and there
+LevelTiles bricks(unsigned int columns, unsigned int rows)
+{
+  LevelTiles level {columns, rows, {}};
+  level.Codes.resize(std::size_t {columns} * rows);
+  for (std::size_t i = 0; i < level.Codes.size(); ++i)
+    level.Codes[i] = static_cast<std::uint8_t>(i % 7 == 0 ? 1 : 2 + i % 4);
+  return level;
+}
+
+std::string toText(const LevelTiles& level)
+{
+  std::string text;
+  for (unsigned int y = 0; y < level.Rows; ++y) {
+    for (unsigned int x = 0; x < level.Columns; ++x) {
+      text += std::to_string(level.Codes[y * level.Columns + x]);
+      text += x + 1 < level.Columns ? ' ' : '\n';
+    }
+  }
+  return text;
+}
+}  // namespace
+
+TEST_CASE("text levels are parsed into tile codes", "[level]")
+{
+  SECTION("rows are filled up to the widest one")
+  {
+    const auto level = ParseTextLevel("1 2 3\r\n\n4  5\n6 7 8 9");
+    REQUIRE(level);
+    REQUIRE(level->Columns == 4);
+    REQUIRE(level->Rows == 3);
+    REQUIRE(level->Codes
+            == std::vector<std::uint8_t> {1, 2, 3, 0, 4, 5, 0, 0, 6, 7, 8, 9});
+  }
+
+  SECTION("codes must be bytes")
+  {
+    REQUIRE_FALSE(ParseTextLevel("1 256"));
+    REQUIRE_FALSE(ParseTextLevel("1 x 2"));
+    REQUIRE_FALSE(ParseTextLevel("1 -2"));
+    REQUIRE(ParseTextLevel("")->Rows == 0);
+  }
+}
+
+TEST_CASE("binary level files", "[level]")
+{
+  const fs::path path = fs::temp_directory_path() / "breakout_level.blvl";
+  const LevelTiles level = bricks(15, 8);
+  REQUIRE(SaveLevelFile(level, "name=test\n", path));
+
+  SECTION("hold the tiles and metadata")
+  {
+    const auto file = LevelFile::Open(path);
+    REQUIRE(file);
+    REQUIRE(file->Columns() == 15);
+    REQUIRE(file->Rows() == 8);
+    REQUIRE(std::vector<std::uint8_t>(file->Tiles().begin(),
+                                      file->Tiles().end())
+            == level.Codes);
+    REQUIRE(file->Metadata() == "name=test\n");
+  }
+
+  SECTION("load into the same level as their text")
+  {
+    const fs::path textPath = fs::temp_directory_path() / "breakout_level.lvl";
+    std::ofstream(textPath) << toText(level);
+    GameLevel fromBinary;
+    fromBinary.Load(path.string().c_str(), 800, 300);
+    GameLevel fromText;
+    fromText.Load(textPath.string().c_str(), 800, 300);
+    REQUIRE(fromBinary.Bricks.Positions == fromText.Bricks.Positions);
+    REQUIRE(fromBinary.Bricks.Types == fromText.Bricks.Types);
+    fs::remove(textPath);
+  }
+
+  SECTION("that are cut short are refused")
+  {
+    fs::resize_file(path, fs::file_size(path) - 12);
+    REQUIRE_FALSE(LevelFile::Open(path));
+  }
+
+  SECTION("of another format are refused")
+  {
+    std::ofstream(path) << toText(level);
+    REQUIRE_FALSE(LevelFile::Open(path));
+  }
+
+  fs::remove(path);
+}
+
+TEST_CASE("level load time, text and binary", "[.benchmark][level]")
+{
+  const fs::path dir = fs::temp_directory_path() / "breakout_level_bench";
+  fs::create_directories(dir);
+  for (unsigned int size : {64u, 512u}) {
+    const LevelTiles level = bricks(size, size);
+    const std::string name = std::to_string(size) + "x" + std::to_string(size);
+    const std::string text = (dir / (name + ".lvl")).string();
+    const std::string binary = (dir / (name + ".blvl")).string();
+    std::ofstream(text) << toText(level);
+    REQUIRE(SaveLevelFile(level, {}, binary));
+
+    GameLevel loaded;
+    BENCHMARK("text, " + name + " tiles")
+    {
+      loaded.Load(text.c_str(), 800, 300);
+      return loaded.Bricks.Count();
+    };
+    BENCHMARK("binary, " + name + " tiles")
+    {
+      loaded.Load(binary.c_str(), 800, 300);
+      return loaded.Bricks.Count();
+    };
+  }
+
+  // mapping is all opening costs, whatever the size
+  const std::string huge = (dir / "4096x4096.blvl").string();
+  REQUIRE(SaveLevelFile(bricks(4096, 4096), {}, huge));
+  BENCHMARK("opening a binary 4096x4096 level")
+  {
+    return LevelFile::Open(huge)->Tiles().size();
+  };
+  fs::remove_all(dir);
+}
@@ -0,0 +1,40 @@
+#include "gl_context.h"
+#include "particle_generator.h"
+#include "resource_manager.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+TEST_CASE("particles render with one instanced draw call",
+          "[particles][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+
+  Shader& shader = ResourceManager::LoadShader(
+      "shaders/particle.vert", "shaders/particle.frag", nullptr, "particle");
+  std::vector<unsigned char> pixels(4 * 4 * 4, 255);
+  Texture2D texture;
+  texture.Internal_Format = GL_RGBA;
+  texture.Image_Format = GL_RGBA;
+  texture.Generate(4, 4, pixels.data());
+
+  ParticleGenerator particles(shader, texture, 50000);
+  const GameObject emitter(glm::vec2(32.0f), glm::vec2(8.0f));
+
+  particles.Draw();
+  CHECK(particles.GetStats().DrawCalls == 0);
+
+  for (unsigned int spawned : {10u, 1000u, 40000u}) {
+    particles.Update(0.0f, emitter, spawned);
+    particles.Draw();
+    CHECK(particles.GetStats().Particles >= spawned);
+    CHECK(particles.GetStats().DrawCalls == 1);
+  }
+
+  REQUIRE(glGetError() == GL_NO_ERROR);
+}
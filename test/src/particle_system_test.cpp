@@ -0,0 +1,205 @@
+#include "particle_system.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+constexpr float dt = 1.0f / 60.0f;
+
+// Small deterministic generator so runs are comparable
+struct Lcg
+{
+  unsigned int State = 12345u;
+
+  float Next()
+  {
+    State = State * 1664525u + 1013904223u;
+    return static_cast<float>(State >> 8) / 16777216.0f;
+  }
+};
+
+// Spawns count particles with lifetimes spread over (0, 1] seconds, so about
+// count * dt of them die every frame
+template<typename Particles>
+void fill(Particles& particles, unsigned int count)
+{
+  Lcg random;
+  for (unsigned int i = 0; i < count; ++i)
+    particles.Spawn(glm::vec2(random.Next() * 800.0f, random.Next() * 600.0f),
+                    glm::vec2(random.Next() - 0.5f, random.Next()) * 35.0f,
+                    glm::vec4(0.5f + random.Next() * 0.5f),
+                    1.0f - random.Next());
+}
+
+// The array-of-structures generator the SoA store replaced, kept as the
+// baseline for the benchmarks: dead particles stay in place and spawning
+// searches for one
+class LegacyParticles
+{
+public:
+  struct Particle
+  {
+    glm::vec2 Position {0.0f}, Velocity {0.0f};
+    glm::vec4 Color {1.0f};
+    float Life = 0.0f;
+  };
+
+  explicit LegacyParticles(unsigned int amount)
+      : particles(amount)
+  {
+  }
+
+  void Spawn(glm::vec2 position,
+             glm::vec2 velocity,
+             glm::vec4 color,
+             float lifetime)
+  {
+    Particle& particle = this->particles[this->firstUnusedParticle()];
+    particle.Position = position;
+    particle.Velocity = velocity;
+    particle.Color = color;
+    particle.Life = lifetime;
+  }
+
+  void Update(float step)
+  {
+    for (Particle& p : this->particles) {
+      p.Life -= step;
+      if (p.Life > 0.0f) {
+        p.Position -= p.Velocity * step;
+        p.Color.a -= step * 2.5f;
+      }
+    }
+  }
+
+private:
+  unsigned int firstUnusedParticle()
+  {
+    const auto amount = static_cast<unsigned int>(this->particles.size());
+    for (unsigned int i = this->lastUsed; i < amount; ++i)
+      if (this->particles[i].Life <= 0.0f)
+        return this->lastUsed = i;
+    for (unsigned int i = 0; i < this->lastUsed; ++i)
+      if (this->particles[i].Life <= 0.0f)
+        return this->lastUsed = i;
+    return this->lastUsed = 0;
+  }
+
+  std::vector<Particle> particles;
+  unsigned int lastUsed = 0;
+};
+}  // namespace
+
+TEST_CASE("spawned particles live in a dense range", "[particles]")
+{
+  ParticleSystem particles(8);
+  particles.Spawn(glm::vec2(1.0f), glm::vec2(0.0f), glm::vec4(1.0f), 0.5f);
+  particles.Spawn(glm::vec2(2.0f), glm::vec2(0.0f), glm::vec4(1.0f), 2.0f);
+  particles.Spawn(glm::vec2(3.0f), glm::vec2(0.0f), glm::vec4(1.0f), 0.5f);
+  REQUIRE(particles.Size() == 3);
+
+  // the short-lived ones die, the survivor is moved to the front
+  particles.Update(1.0f);
+  REQUIRE(particles.Size() == 1);
+  REQUIRE(particles.Position(0).x == Catch::Approx(2.0f));
+  REQUIRE(particles.Lives()[0] == Catch::Approx(1.0f));
+}
+
+TEST_CASE("a full particle pool recycles live particles", "[particles]")
+{
+  ParticleSystem particles(4);
+  for (int i = 0; i < 10; ++i)
+    particles.Spawn(glm::vec2(static_cast<float>(i)),
+                    glm::vec2(0.0f),
+                    glm::vec4(1.0f),
+                    1.0f);
+  REQUIRE(particles.Size() == particles.Capacity());
+
+  // round-robin: slots 0 and 1 were overwritten twice, 2 and 3 once
+  REQUIRE(particles.Position(0).x == Catch::Approx(8.0f));
+  REQUIRE(particles.Position(1).x == Catch::Approx(9.0f));
+  REQUIRE(particles.Position(2).x == Catch::Approx(6.0f));
+  REQUIRE(particles.Position(3).x == Catch::Approx(7.0f));
+}
+
+TEST_CASE("SIMD particle kernels match the scalar kernel", "[particles]")
+{
+  // not a multiple of any vector width, to cover the padded tail
+  constexpr unsigned int count = 1003;
+  ParticleSystem reference(count);
+  reference.SetKernel(ParticleSystem::Kernel::Scalar);
+  fill(reference, count);
+
+  for (auto kernel : {ParticleSystem::Kernel::SSE2,
+                      ParticleSystem::Kernel::AVX2,
+                      ParticleSystem::Kernel::NEON})
+  {
+    if (!ParticleSystem::IsSupported(kernel))
+      continue;
+    INFO(ParticleSystem::KernelName(kernel));
+    ParticleSystem particles(count);
+    particles.SetKernel(kernel);
+    REQUIRE(particles.GetKernel() == kernel);
+    fill(particles, count);
+
+    ParticleSystem expected = reference;
+    for (int frame = 0; frame < 30; ++frame) {
+      particles.Update(dt);
+      expected.Update(dt);
+    }
+    REQUIRE(particles.Size() == expected.Size());
+    REQUIRE(particles.Size() < count);
+    for (unsigned int i = 0; i < particles.Size(); ++i) {
+      REQUIRE(particles.PositionsX()[i]
+              == Catch::Approx(expected.PositionsX()[i]));
+      REQUIRE(particles.PositionsY()[i]
+              == Catch::Approx(expected.PositionsY()[i]));
+      REQUIRE(particles.ColorsA()[i] == Catch::Approx(expected.ColorsA()[i]));
+    }
+  }
+}
+
+TEST_CASE("particle update throughput", "[.benchmark][particles]")
+{
+  INFO(ParticleSystem::KernelName(ParticleSystem::BestKernel()));
+  for (unsigned int count : {500u, 50000u, 1000000u}) {
+    // particles live half a second on average, so respawning 2 * count * dt
+    // of them per frame keeps the pools about full
+    const auto respawn =
+        static_cast<unsigned int>(2.0f * static_cast<float>(count) * dt) + 1;
+    const std::string size = std::to_string(count);
+
+    LegacyParticles legacy(count);
+    fill(legacy, count);
+    BENCHMARK("legacy AoS, " + size + " particles")
+    {
+      fill(legacy, respawn);
+      legacy.Update(dt);
+    };
+
+    ParticleSystem scalar(count);
+    scalar.SetKernel(ParticleSystem::Kernel::Scalar);
+    fill(scalar, count);
+    BENCHMARK("SoA scalar, " + size + " particles")
+    {
+      fill(scalar, respawn);
+      scalar.Update(dt);
+      return scalar.Size();
+    };
+
+    ParticleSystem simd(count);
+    fill(simd, count);
+    const std::string kernel = ParticleSystem::KernelName(simd.GetKernel());
+    BENCHMARK("SoA " + kernel + ", " + size + " particles")
+    {
+      fill(simd, respawn);
+      simd.Update(dt);
+      return simd.Size();
+    };
+  }
+}
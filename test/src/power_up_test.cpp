@@ -0,0 +1,46 @@
+#include "power_up.h"
+
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstddef>
+#include <vector>
+
+TEST_CASE("power-ups keep their slot until removed", "[powerup]")
+{
+  PowerUpPool pool;
+  const auto first = pool.Spawn(PowerUpType::Sticky, glm::vec2(1.0f));
+  const auto second = pool.Spawn(PowerUpType::Chaos, glm::vec2(2.0f));
+  const auto third = pool.Spawn(PowerUpType::Speed, glm::vec2(3.0f));
+  REQUIRE(pool.Size() == 3);
+  REQUIRE(pool[second].Type == PowerUpType::Chaos);
+  REQUIRE(pool[second].Duration
+          == Catch::Approx(GetPowerUpInfo(PowerUpType::Chaos).Duration));
+
+  pool.Remove(second);
+  REQUIRE_FALSE(pool.IsUsed(second));
+  REQUIRE(pool[third].Position.x == Catch::Approx(3.0f));
+
+  // a freed slot is reused, by a power-up with a new serial
+  const auto serial = pool.Serial(second);
+  REQUIRE(pool.Spawn(PowerUpType::Confuse, glm::vec2(4.0f)) == second);
+  REQUIRE(pool.Serial(second) != serial);
+
+  std::vector<std::size_t> slots;
+  pool.ForEach([&slots](std::size_t slot, const PowerUp&)
+               { slots.push_back(slot); });
+  REQUIRE(slots == std::vector<std::size_t> {first, second, third});
+}
+
+TEST_CASE("a full power-up pool drops new power-ups", "[powerup]")
+{
+  PowerUpPool pool;
+  for (std::size_t i = 0; i < PowerUpPool::Capacity; ++i)
+    REQUIRE(pool.Spawn(PowerUpType::Speed, glm::vec2(0.0f)) == i);
+  REQUIRE(pool.Spawn(PowerUpType::Speed, glm::vec2(0.0f))
+          == PowerUpPool::Capacity);
+  REQUIRE(pool.Size() == PowerUpPool::Capacity);
+
+  pool.Clear();
+  REQUIRE(pool.Size() == 0);
+}
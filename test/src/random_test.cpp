@@ -0,0 +1,68 @@
+#include "random.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+
+TEST_CASE("random numbers match the PCG32 reference", "[random]")
+{
+  // the first numbers of pcg32-demo, seeded with 42 on stream 54
+  Random random(42u, 54u);
+  for (std::uint32_t expected :
+       {0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu})
+    REQUIRE(random.Next() == expected);
+}
+
+TEST_CASE("random streams are reproducible and independent", "[random]")
+{
+  Random first(7u, RandomStream::Gameplay);
+  Random again(7u, RandomStream::Gameplay);
+  Random other(7u, RandomStream::Particles);
+  unsigned int same = 0;
+  for (int i = 0; i < 1000; ++i) {
+    const std::uint32_t number = first.Next();
+    REQUIRE(again.Next() == number);
+    same += other.Next() == number ? 1u : 0u;
+  }
+  REQUIRE(same < 2);
+}
+
+TEST_CASE("bounded random numbers cover their range", "[random]")
+{
+  Random random(1u);
+  std::array<unsigned int, 6> counts {};
+  for (int i = 0; i < 6000; ++i)
+    ++counts[random.Below(6)];
+  for (unsigned int count : counts)
+    REQUIRE((count > 850 && count < 1150));
+
+  for (int i = 0; i < 1000; ++i) {
+    const float number = random.NextFloat();
+    REQUIRE((number >= 0.0f && number < 1.0f));
+    const float ranged = random.Range(-5.0f, 5.0f);
+    REQUIRE((ranged >= -5.0f && ranged < 5.0f));
+  }
+}
+
+TEST_CASE("random number cost", "[.benchmark][random]")
+{
+  BENCHMARK("rand() % 75, 1000 numbers")
+  {
+    unsigned int sum = 0;
+    for (int i = 0; i < 1000; ++i)
+      sum += static_cast<unsigned int>(std::rand()) % 75u;
+    return sum;
+  };
+
+  Random random(1u);
+  BENCHMARK("Random::Below(75), 1000 numbers")
+  {
+    unsigned int sum = 0;
+    for (int i = 0; i < 1000; ++i)
+      sum += random.Below(75);
+    return sum;
+  };
+}
@@ -0,0 +1,144 @@
+#include "controls.h"
+#include "replay.h"
+#include "simulation.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr unsigned int width = 800;
+constexpr unsigned int height = 600;
+constexpr float dt = 1.0f / 120.0f;
+
+// The keys pressed and released in a tick of a scripted game: the next
+// level and hard mode are picked in the menu, then the game is started and
+// the paddle swept from side to side, starting the game again whenever it
+// is over. Keys the game ignores are mixed in.
+std::vector<KeyEvent> scriptedKeys(unsigned long long tick)
+{
+  std::vector<KeyEvent> keys;
+  if (tick == 1)
+    keys = {{Key::W, true}, {81, true}};
+  else if (tick == 2)
+    keys = {{Key::W, false}, {Key::H, true}, {Key::H, false}, {-1, true}};
+  else if (tick == 5)
+    keys = {{Key::Enter, true}};
+  else if (tick == 6)
+    keys = {{Key::Enter, false}, {Key::Space, true}};
+  else if (tick % 90 == 0)
+    keys = {{Key::A, (tick / 90) % 2 == 0},
+            {Key::D, (tick / 90) % 2 == 1},
+            {Key::Enter, true}};
+  else if (tick % 90 == 45)
+    keys = {{Key::Enter, false}};
+  return keys;
+}
+
+// Plays the scripted game for the given ticks the way the game does,
+// recording it to file; returns the hash of the state it ends in
+std::uint64_t record(const fs::path& file, unsigned long long ticks)
+{
+  Simulation sim(width, height, 1234);
+  sim.Init();
+  ReplayRecorder recorder(file, sim, dt);
+  REQUIRE(recorder.IsOpen());
+  Controls controls;
+  for (unsigned long long tick = 1; tick <= ticks; ++tick) {
+    const auto keys = scriptedKeys(tick);
+    recorder.RecordTick(keys);
+    sim.Step(dt, controls.Apply(sim, keys));
+  }
+  REQUIRE(sim.Level == 1);
+  REQUIRE(sim.IsHardModeOn());
+  REQUIRE(recorder.Finish(sim));
+  return HashState(sim);
+}
+}  // namespace
+
+TEST_CASE("a recorded game replays exactly", "[replay]")
+{
+  const fs::path file = fs::temp_directory_path() / "breakout.brep";
+  const std::uint64_t state = record(file, 6000);
+  REQUIRE_FALSE(fs::exists(fs::path(file) += ".tmp"));
+
+  const auto replay = Replay::Open(file);
+  REQUIRE(replay);
+  REQUIRE(replay->Setup().Width == width);
+  REQUIRE(replay->Setup().Seed == 1234);
+  REQUIRE(replay->Setup().TickSeconds == Catch::Approx(dt));
+  REQUIRE(replay->Ticks() == 6000);
+  REQUIRE(replay->FinalState() == state);
+  // only the keys the game reacts to are kept
+  std::size_t bound = 0;
+  for (unsigned long long tick = 1; tick <= 6000; ++tick)
+    for (const KeyEvent& event : scriptedKeys(tick))
+      bound += Controls::IsBound(event.Key) ? 1u : 0u;
+  REQUIRE(replay->EventCount() == bound);
+
+  SECTION("playing it again ends in the same state")
+  {
+    Simulation sim(width, height);
+    sim.Init();
+    REQUIRE(replay->Play(sim) == state);
+    REQUIRE(sim.Level == 1);
+    REQUIRE(sim.IsHardModeOn());
+  }
+
+  SECTION("a game on other levels diverges")
+  {
+    Simulation sim(width, height);
+    sim.Init();
+    sim.Levels[1] = sim.Levels[0];
+    REQUIRE(replay->Play(sim) != state);
+  }
+
+  SECTION("damaged recordings are rejected")
+  {
+    fs::resize_file(file, fs::file_size(file) - 1);
+    REQUIRE_FALSE(Replay::Open(file));
+    std::ofstream(file) << "BKREPLAY but not really";
+    REQUIRE_FALSE(Replay::Open(file));
+  }
+
+  fs::remove(file);
+}
+
+TEST_CASE("an unfinished recording is discarded", "[replay]")
+{
+  const fs::path file = fs::temp_directory_path() / "breakout_cut.brep";
+  {
+    Simulation sim(width, height);
+    sim.Init();
+    ReplayRecorder recorder(file, sim, dt);
+    REQUIRE(recorder.IsOpen());
+    for (unsigned long long tick = 1; tick <= 100; ++tick)
+      recorder.RecordTick(scriptedKeys(tick));
+  }
+  REQUIRE_FALSE(fs::exists(file));
+  REQUIRE_FALSE(fs::exists(fs::path(file) += ".tmp"));
+}
+
+TEST_CASE("replay throughput", "[.benchmark][replay]")
+{
+  const fs::path file = fs::temp_directory_path() / "breakout_bench.brep";
+  record(file, 12000);
+  const auto replay = Replay::Open(file);
+  REQUIRE(replay);
+
+  BENCHMARK("100 s of a recorded game")
+  {
+    Simulation sim(width, height);
+    sim.Init();
+    return replay->Play(sim);
+  };
+  fs::remove(file);
+}
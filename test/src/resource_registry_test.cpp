@@ -0,0 +1,139 @@
+#include "resource_registry.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <array>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+// The names the game looks sprites up by every frame
+constexpr std::array<std::string_view, 10> spriteNames {"background",
+                                                        "block",
+                                                        "block_solid",
+                                                        "paddle",
+                                                        "face",
+                                                        "powerup_speed",
+                                                        "powerup_sticky",
+                                                        "powerup_increase",
+                                                        "powerup_confuse",
+                                                        "powerup_chaos"};
+
+// ids are computed by the compiler and match the ones of run time names
+static_assert("block"_id == ResourceId::Of("block"));
+static_assert("block"_id != "block_solid"_id);
+}  // namespace
+
+TEST_CASE("resources are found by the id of their name", "[resources]")
+{
+  ResourceRegistry<int> registry;
+  REQUIRE_FALSE(registry.Find("block"_id).IsValid());
+  REQUIRE(registry.TryGet("block"_id) == nullptr);
+
+  const auto block = registry.Add("block", 1);
+  const auto paddle = registry.Add("paddle", 2);
+  REQUIRE(block.IsValid());
+  REQUIRE(paddle.IsValid());
+  REQUIRE(registry.Size() == 2);
+  REQUIRE(registry.Find("block"_id) == block);
+  REQUIRE(registry.Find(ResourceId::Of("paddle")) == paddle);
+  REQUIRE(registry[block] == 1);
+  REQUIRE(*registry.TryGet("paddle"_id) == 2);
+  REQUIRE(registry.Name(paddle) == "paddle");
+  REQUIRE_FALSE(registry.Find("face"_id).IsValid());
+
+  SECTION("adding a taken name fails")
+  {
+    REQUIRE_FALSE(registry.Add("block", 3).IsValid());
+    REQUIRE(registry[block] == 1);
+  }
+
+  SECTION("setting a taken name replaces the resource in place")
+  {
+    const int* stored = &registry[block];
+    REQUIRE(registry.Set("block", 3) == block);
+    REQUIRE(&registry[block] == stored);
+    REQUIRE(*stored == 3);
+    REQUIRE(registry.Size() == 2);
+  }
+
+  SECTION("clearing forgets all resources")
+  {
+    registry.Clear();
+    REQUIRE(registry.Size() == 0);
+    REQUIRE_FALSE(registry.Find("block"_id).IsValid());
+  }
+}
+
+TEST_CASE("handles and references survive growing the registry",
+          "[resources]")
+{
+  ResourceRegistry<std::string> registry;
+  const auto first = registry.Add("first", "first value");
+  const std::string* stored = &registry[first];
+  for (int i = 0; i < 1000; ++i)
+    REQUIRE(registry.Add("texture" + std::to_string(i), "value").IsValid());
+
+  REQUIRE(registry.Find("first"_id) == first);
+  REQUIRE(&registry[first] == stored);
+  REQUIRE(*stored == "first value");
+  for (int i = 0; i < 1000; ++i) {
+    const auto handle = registry.Find(
+        ResourceId::Of("texture" + std::to_string(i)));
+    REQUIRE(handle.IsValid());
+    REQUIRE(handle.Index == static_cast<unsigned int>(i) + 1);
+  }
+}
+
+TEST_CASE("resource lookup cost", "[.benchmark][resources]")
+{
+  // about as many resources as the game loads
+  std::map<std::string, int> names;
+  ResourceRegistry<int> registry;
+  for (int i = 0; i < 30; ++i) {
+    const std::string name = "resource" + std::to_string(i);
+    names.emplace(name, i);
+    registry.Add(name, i);
+  }
+  for (std::size_t i = 0; i < spriteNames.size(); ++i) {
+    const std::string name {spriteNames[i]};
+    names.emplace(name, static_cast<int>(i));
+    registry.Add(name, static_cast<int>(i));
+  }
+
+  // what a frame's lookups cost before: a std::string built from a literal,
+  // then compared along the tree
+  BENCHMARK("std::map<std::string> by literal, 10 lookups")
+  {
+    int sum = 0;
+    for (std::string_view name : spriteNames)
+      sum += names.find(std::string(name))->second;
+    return sum;
+  };
+
+  BENCHMARK("registry by compile-time id, 10 lookups")
+  {
+    return *registry.TryGet("background"_id) + *registry.TryGet("block"_id)
+        + *registry.TryGet("block_solid"_id) + *registry.TryGet("paddle"_id)
+        + *registry.TryGet("face"_id) + *registry.TryGet("powerup_speed"_id)
+        + *registry.TryGet("powerup_sticky"_id)
+        + *registry.TryGet("powerup_increase"_id)
+        + *registry.TryGet("powerup_confuse"_id)
+        + *registry.TryGet("powerup_chaos"_id);
+  };
+
+  std::array<ResourceHandle<int>, spriteNames.size()> handles;
+  for (std::size_t i = 0; i < spriteNames.size(); ++i)
+    handles[i] = registry.Find(ResourceId::Of(spriteNames[i]));
+  BENCHMARK("registry by handle, 10 lookups")
+  {
+    int sum = 0;
+    for (ResourceHandle<int> handle : handles)
+      sum += registry[handle];
+    return sum;
+  };
+}
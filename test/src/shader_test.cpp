@@ -0,0 +1,176 @@
+#include "gl_context.h"
+#include "program_cache.h"
+#include "resource_manager.h"
+#include "shader.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace
+{
+std::string readFile(const char* path)
+{
+  std::ifstream file(path);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  return contents.str();
+}
+}  // namespace
+
+TEST_CASE("shader resolves uniforms once at link time", "[shader][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+
+  Shader shader = ResourceManager::LoadShader("shaders/post_processing.vert",
+                                              "shaders/post_processing.frag",
+                                              nullptr,
+                                              "postprocessing");
+  shader.Use();
+
+  SECTION("handles")
+  {
+    CHECK(shader.Uniform<float>("time").Slot >= 0);
+    // arrays are found by their plain name
+    CHECK(shader.Uniform<glm::vec2>("offsets").Slot >= 0);
+    CHECK(shader.Uniform<float>("no_such_uniform").Slot == -1);
+    // setting an unresolved handle is a no-op
+    shader.Set(UniformHandle<float> {}, 1.0f);
+  }
+
+  SECTION("unchanged values are not uploaded again")
+  {
+    const auto time = shader.Uniform<float>("time");
+    const GLint location = glGetUniformLocation(shader.ID, "time");
+    float uploaded = 0.0f;
+
+    shader.Set(time, 1.0f);
+    glGetUniformfv(shader.ID, location, &uploaded);
+    CHECK(uploaded == Catch::Approx(1.0f));
+
+    // change the value behind the cache's back; an equal value is elided,
+    // so the driver keeps the foreign one
+    glUniform1f(location, 2.0f);
+    shader.Set(time, 1.0f);
+    glGetUniformfv(shader.ID, location, &uploaded);
+    CHECK(uploaded == Catch::Approx(2.0f));
+
+    // copies share the cache
+    Shader copy = shader;
+    copy.Set(time, 3.0f);
+    shader.Set(time, 3.0f);
+    glGetUniformfv(shader.ID, location, &uploaded);
+    CHECK(uploaded == Catch::Approx(3.0f));
+  }
+
+  REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("program binary cache files", "[shader]")
+{
+  const auto path =
+      std::filesystem::temp_directory_path() / "breakout_program_test.bin";
+  const ProgramBinary binary {0x1234, {1, 2, 3, 4, 5}};
+  REQUIRE(SaveProgramBinary(binary, 7, path));
+
+  const auto loaded = LoadProgramBinary(7, path);
+  REQUIRE(loaded);
+  CHECK(loaded->Format == binary.Format);
+  CHECK(loaded->Data == binary.Data);
+  CHECK_FALSE(LoadProgramBinary(8, path));
+
+  // the driver and every stage are part of the key
+  const auto key = ProgramBinaryKey("Mesa\nllvmpipe\n4.5", {"a", "bc"});
+  CHECK(ProgramBinaryKey("Mesa\nllvmpipe\n4.6", {"a", "bc"}) != key);
+  CHECK(ProgramBinaryKey("Mesa\nllvmpipe\n4.5", {"ab", "c"}) != key);
+  CHECK(ProgramBinaryKey("Mesa\nllvmpipe\n4.5", {"a", "bc", ""}) != key);
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("linked programs are cached as driver binaries", "[shader][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+  if (!Shader::BinariesSupported()) {
+    WARN("The driver doesn't support program binaries, skipping");
+    return;
+  }
+
+  const char* vertex = "shaders/sprite.vert";
+  const char* fragment = "shaders/sprite.frag";
+  const std::filesystem::path cacheFile = "cache/shaders/binary_test.bin";
+  std::filesystem::remove(cacheFile);
+  const auto key = ProgramBinaryKey(DriverIdentity(),
+                                    {readFile(vertex), readFile(fragment), ""});
+
+  // the first load compiles and stores the binary, the second uses it
+  ResourceManager::LoadShader(vertex, fragment, nullptr, "binary_test");
+  const auto stored = LoadProgramBinary(key, cacheFile);
+  REQUIRE(stored);
+  Shader shader =
+      ResourceManager::LoadShader(vertex, fragment, nullptr, "binary_test");
+  CHECK(shader.Uniform<glm::mat4>("projection").Slot >= 0);
+
+  SECTION("a rejected binary is compiled again")
+  {
+    REQUIRE(SaveProgramBinary(
+        ProgramBinary {stored->Format, {1, 2, 3}}, key, cacheFile));
+    shader =
+        ResourceManager::LoadShader(vertex, fragment, nullptr, "binary_test");
+    CHECK(shader.Uniform<glm::mat4>("projection").Slot >= 0);
+    // and the broken binary is replaced
+    const auto replaced = LoadProgramBinary(key, cacheFile);
+    REQUIRE(replaced);
+    CHECK(replaced->Data.size() > 3);
+  }
+
+  std::filesystem::remove(cacheFile);
+  REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("program creation from source and from binary",
+          "[.benchmark][shader][gl]")
+{
+  HeadlessContext context;
+  if (!context || !Shader::BinariesSupported()) {
+    WARN("No OpenGL context with program binaries available, skipping");
+    return;
+  }
+  const std::string vertex = readFile("shaders/particle.vert");
+  const std::string fragment = readFile("shaders/particle.frag");
+  Shader compiled;
+  compiled.Compile(vertex.c_str(), fragment.c_str());
+  const auto binary = compiled.GetBinary();
+  REQUIRE(binary);
+
+  // drivers may cache compiled shaders themselves (Mesa does unless
+  // MESA_SHADER_CACHE_DISABLE=true), which narrows the gap
+  BENCHMARK("compile and link")
+  {
+    Shader shader;
+    shader.Compile(vertex.c_str(), fragment.c_str());
+    glDeleteProgram(shader.ID);
+    return shader.ID;
+  };
+  BENCHMARK("load binary")
+  {
+    Shader shader;
+    shader.LoadBinary(*binary);
+    glDeleteProgram(shader.ID);
+    return shader.ID;
+  };
+  glDeleteProgram(compiled.ID);
+}
@@ -0,0 +1,298 @@
+#include "level_file.h"
+#include "simulation.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+constexpr unsigned int width = 800;
+constexpr unsigned int height = 600;
+constexpr float dt = 1.0f / 60.0f;
+
+bool hasEvent(const Simulation& sim, SimEventType type)
+{
+  const auto& events = sim.Events();
+  return std::any_of(events.begin(),
+                     events.end(),
+                     [type](const SimEvent& event)
+                     { return event.Type == type; });
+}
+}  // namespace
+
+TEST_CASE("simulation steps without a GL context", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  REQUIRE(sim.Levels.size() == 4);
+  REQUIRE(sim.Levels[0].Bricks.Count() > 0);
+
+  sim.Start();
+  REQUIRE(sim.State == GAME_ACTIVE);
+
+  const float startY = sim.Ball.Position.y;
+  sim.Step(dt, SimInput {false, false, true});
+  REQUIRE_FALSE(sim.Ball.Stuck);
+  REQUIRE(sim.Ball.Position.y < startY);
+}
+
+TEST_CASE("paddle input moves a stuck ball along", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  const float paddleX = sim.Player.Position.x;
+  const float ballX = sim.Ball.Position.x;
+  sim.Step(dt, SimInput {true, false, false});
+  REQUIRE(sim.Player.Position.x < paddleX);
+  REQUIRE(sim.Player.Position.x - paddleX
+          == Catch::Approx(sim.Ball.Position.x - ballX));
+}
+
+TEST_CASE("destroying a brick reports an event", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  // a brick of the bottom row
+  const GameLevel& level = sim.Levels[sim.Level];
+  const BrickLayout& bricks = level.Bricks;
+  std::size_t brick = bricks.Count() - 1;
+  while (brick > 0 && bricks.IsSolid(brick))
+    --brick;
+  REQUIRE_FALSE(bricks.IsSolid(brick));
+
+  // place the ball just below the brick, moving up into it
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = bricks.Positions[brick]
+      + glm::vec2(bricks.Size.x / 2.0f - sim.Ball.Radius, bricks.Size.y + 1.0f);
+  sim.Ball.Velocity = glm::vec2(0.0f, -100.0f);
+  sim.Step(dt, SimInput {});
+
+  REQUIRE(level.IsDestroyed(brick));
+  REQUIRE(hasEvent(sim, SimEventType::BrickDestroyed));
+  REQUIRE(sim.Ball.Velocity.y > 0.0f);
+}
+
+TEST_CASE("missing the ball costs a life", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = glm::vec2(10.0f, static_cast<float>(height) - 1.0f);
+  sim.Ball.Velocity = glm::vec2(0.0f, 100.0f);
+  sim.Step(dt, SimInput {});
+
+  REQUIRE(sim.Lives == 2);
+  REQUIRE(hasEvent(sim, SimEventType::LifeLost));
+  REQUIRE(sim.Ball.Stuck);
+}
+
+TEST_CASE("losing the last life starts the level over", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+  GameLevel& level = sim.Levels[sim.Level];
+  const std::size_t remaining = level.RemainingBricks();
+  level.Destroy(0);
+  level.Destroy(level.Bricks.Count() - 1);
+
+  sim.Lives = 1;
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = glm::vec2(10.0f, static_cast<float>(height) - 1.0f);
+  sim.Ball.Velocity = glm::vec2(0.0f, 100.0f);
+  sim.Step(dt, SimInput {});
+
+  REQUIRE(sim.State == GAME_MENU);
+  REQUIRE(sim.Lives == 3);
+  REQUIRE(level.RemainingBricks() == remaining);
+}
+
+TEST_CASE("an effect lasts until its last power-up runs out", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  // two sticky power-ups caught by the paddle at once
+  const auto first =
+      sim.PowerUps.Spawn(PowerUpType::Sticky, sim.Player.Position);
+  const auto second =
+      sim.PowerUps.Spawn(PowerUpType::Sticky, sim.Player.Position);
+  sim.Step(dt, SimInput {});
+  REQUIRE(sim.IsPowerUpActive(PowerUpType::Sticky));
+  REQUIRE(sim.Ball.Sticky);
+
+  sim.PowerUps[first].Duration = dt / 2.0f;
+  sim.Step(dt, SimInput {});
+  REQUIRE_FALSE(sim.PowerUps.IsUsed(first));
+  REQUIRE(sim.Ball.Sticky);
+
+  sim.PowerUps[second].Duration = dt / 2.0f;
+  sim.Step(dt, SimInput {});
+  REQUIRE_FALSE(sim.IsPowerUpActive(PowerUpType::Sticky));
+  REQUIRE_FALSE(sim.Ball.Sticky);
+  REQUIRE(sim.PowerUps.Size() == 0);
+}
+
+TEST_CASE("a fast ball doesn't tunnel through bricks", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  const GameLevel& level = sim.Levels[sim.Level];
+  const glm::vec2 bottom = level.Bricks.Positions.back();
+  const float levelBottom = bottom.y + level.Bricks.Size.y;
+
+  // 50 pixels below the bricks, covering 250 pixels in one step
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = glm::vec2(bottom.x, levelBottom + 50.0f);
+  sim.Ball.Velocity = glm::vec2(0.0f, -250.0f / dt);
+  sim.Step(dt, SimInput {});
+
+  // only the brick right above was hit, and the ball bounced back down
+  REQUIRE(level.IsDestroyed(level.Bricks.Count() - 1));
+  REQUIRE(level.AliveBricks().Count() == level.Bricks.Count() - 1);
+  REQUIRE(sim.Ball.Velocity.y > 0.0f);
+  REQUIRE(sim.Ball.Position.y == Catch::Approx(levelBottom + 200.0f));
+}
+
+TEST_CASE("a fast ball bounces off the paddle", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  // centered over the paddle, falling further than the paddle is away
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = glm::vec2(
+      sim.Player.Position.x + sim.Player.Size.x / 2.0f - sim.Ball.Radius,
+      400.0f);
+  sim.Ball.Velocity = glm::vec2(0.0f, 250.0f / dt);
+  sim.Step(dt, SimInput {});
+
+  REQUIRE(hasEvent(sim, SimEventType::PaddleHit));
+  REQUIRE_FALSE(hasEvent(sim, SimEventType::LifeLost));
+  REQUIRE(sim.Ball.Velocity.y < 0.0f);
+  REQUIRE(sim.Ball.Position.y + sim.Ball.Size.y < sim.Player.Position.y);
+}
+
+TEST_CASE("a fast ball bounces several times per step", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  sim.Start();
+
+  // below the bricks, travelling twice the width of the window in one step:
+  // off the right wall, off the left wall, then 150 pixels to the right
+  sim.Ball.Stuck = false;
+  sim.Ball.Position = glm::vec2(100.0f, 400.0f);
+  sim.Ball.Velocity = glm::vec2(1600.0f / dt, 0.0f);
+  sim.Step(dt, SimInput {});
+
+  REQUIRE(sim.Ball.Velocity.x > 0.0f);
+  REQUIRE(sim.Ball.Position.x == Catch::Approx(150.0f).margin(0.1));
+  REQUIRE(sim.Ball.Position.y == Catch::Approx(400.0f));
+}
+
+TEST_CASE("edited levels are loaded again in place", "[simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+  GameLevel& level = sim.Levels[1];
+  const auto bricks = level.Bricks.Count();
+  level.Destroy(0);
+
+  REQUIRE(sim.ReloadLevel("levels/./02_two.lvl"));
+  REQUIRE(level.Bricks.Count() == bricks);
+  REQUIRE_FALSE(level.IsDestroyed(0));
+
+  REQUIRE_FALSE(sim.ReloadLevel("levels/05_five.lvl"));
+  REQUIRE_FALSE(sim.ReloadLevel("shaders/sprite.vert"));
+}
+
+TEST_CASE("levels are found in their directory", "[simulation]")
+{
+  const fs::path dir = fs::temp_directory_path() / "breakout_levels";
+  fs::remove_all(dir);
+  fs::create_directories(dir);
+  std::ofstream(dir / "2_second.lvl") << "1 2\n";
+  std::ofstream(dir / "1_first.lvl") << "2\n";
+  std::ofstream(dir / "notes.txt") << "3 3 3\n";
+  // a binary level is played instead of its text source
+  REQUIRE(
+      SaveLevelFile(LevelTiles {3, 1, {2, 3, 4}}, "", dir / "1_first.blvl"));
+
+  Simulation sim(width, height);
+  sim.Init(dir);
+  REQUIRE(sim.Levels.size() == 2);
+  REQUIRE(sim.Levels[0].Bricks.Count() == 3);
+  REQUIRE(sim.Levels[1].Bricks.Count() == 2);
+
+  std::ofstream(dir / "2_second.lvl") << "1 2 2 2\n";
+  REQUIRE(sim.ReloadLevel(dir / "2_second.lvl"));
+  REQUIRE(sim.Levels[1].Bricks.Count() == 4);
+  fs::remove_all(dir);
+}
+
+TEST_CASE("a seed decides how a game plays out", "[simulation]")
+{
+  // the power-ups spawned by games with the same input and seed, and with
+  // another seed
+  auto play = [](std::uint64_t seed)
+  {
+    Simulation sim(width, height, seed);
+    sim.Init();
+    sim.Start();
+    std::vector<PowerUpType> spawned;
+    std::uint32_t last = 0;
+    for (int i = 0; i < 3000; ++i) {
+      // pass through the bricks and never lose, so many bricks break
+      sim.Ball.PassThrough = true;
+      sim.Lives = 3;
+      sim.Step(dt, SimInput {(i / 30) % 2 == 0, (i / 30) % 2 == 1, true});
+      sim.PowerUps.ForEach(
+          [&](std::size_t slot, const PowerUp& powerUp)
+          {
+            if (sim.PowerUps.Serial(slot) > last) {
+              last = sim.PowerUps.Serial(slot);
+              spawned.push_back(powerUp.Type);
+            }
+          });
+    }
+    return spawned;
+  };
+  const auto spawned = play(7);
+  REQUIRE_FALSE(spawned.empty());
+  REQUIRE(play(7) == spawned);
+  REQUIRE(play(8) != spawned);
+}
+
+TEST_CASE("simulation throughput", "[.benchmark][simulation]")
+{
+  Simulation sim(width, height);
+  sim.Init();
+
+  BENCHMARK("1000 steps of a running game")
+  {
+    sim.Start();
+    for (int i = 0; i < 1000; ++i)
+      sim.Step(dt, SimInput {(i / 30) % 2 == 0, (i / 30) % 2 == 1, true});
+    return sim.Ball.Position;
+  };
+}
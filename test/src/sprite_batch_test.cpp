@@ -0,0 +1,87 @@
+#include "gl_context.h"
+#include "resource_manager.h"
+#include "sprite_batch.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace
+{
+// Queues a level-like grid of bricks, every seventh of them solid
+void drawBricks(SpriteBatch& batch,
+                const Texture2D& block,
+                const Texture2D& solid,
+                unsigned int columns,
+                unsigned int rows)
+{
+  const glm::vec2 size(8.0f, 4.0f);
+  for (unsigned int y = 0; y < rows; ++y)
+    for (unsigned int x = 0; x < columns; ++x)
+      batch.Draw((x + y * columns) % 7 == 0 ? solid : block,
+                 glm::vec2(static_cast<float>(x), static_cast<float>(y)) * size,
+                 size);
+}
+}  // namespace
+
+TEST_CASE("sprite batch issues one draw call per texture", "[sprite_batch][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+
+  Shader& shader = ResourceManager::LoadShader(
+      "shaders/sprite.vert", "shaders/sprite.frag", nullptr, "sprite");
+  std::vector<unsigned char> pixels(4 * 4 * 3, 255);
+  Texture2D block;
+  block.Generate(4, 4, pixels.data());
+  Texture2D solid;
+  solid.Generate(4, 4, pixels.data());
+
+  SpriteBatch batch(shader);
+
+  SECTION("draw calls scale with textures, not bricks")
+  {
+    for (unsigned int rows : {8u, 64u, 512u}) {
+      batch.Begin();
+      drawBricks(batch, block, solid, 64, rows);
+      batch.End();
+
+      const SpriteBatch::Stats& stats = batch.GetStats();
+      CHECK(stats.Sprites == 64 * rows);
+      CHECK(stats.DrawCalls == 2);
+      CHECK(stats.TextureBinds == 2);
+    }
+  }
+
+  SECTION("flushing keeps layers apart")
+  {
+    batch.Begin();
+    batch.Draw(block, glm::vec2(0.0f), glm::vec2(800.0f, 600.0f));
+    batch.Flush();
+    drawBricks(batch, block, solid, 16, 8);
+    batch.End();
+
+    CHECK(batch.GetStats().DrawCalls == 3);
+  }
+
+  SECTION("regions of one atlas share a draw call")
+  {
+    const TextureRegion left(block, glm::vec4(0.0f, 0.0f, 0.5f, 1.0f));
+    const TextureRegion right(block, glm::vec4(0.5f, 0.0f, 0.5f, 1.0f));
+    batch.Begin();
+    for (unsigned int i = 0; i < 100; ++i)
+      batch.Draw(i % 2 == 0 ? left : right,
+                 glm::vec2(static_cast<float>(i), 0.0f),
+                 glm::vec2(4.0f));
+    batch.End();
+
+    CHECK(batch.GetStats().Sprites == 100);
+    CHECK(batch.GetStats().DrawCalls == 1);
+    CHECK(batch.GetStats().TextureBinds == 1);
+  }
+
+  REQUIRE(glGetError() == GL_NO_ERROR);
+}
@@ -0,0 +1,54 @@
+#include "spsc_queue.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+
+TEST_CASE("queue keeps values in order up to its capacity", "[threads]")
+{
+  SpscQueue<int, 4> queue;
+  int value = 0;
+  REQUIRE_FALSE(queue.Pop(value));
+
+  for (int i = 1; i <= 4; ++i)
+    REQUIRE(queue.Push(i));
+  // full: the newest value is refused, not waited for
+  REQUIRE_FALSE(queue.Push(5));
+
+  REQUIRE(queue.Pop(value));
+  REQUIRE(value == 1);
+  // the freed slot is reused across the wrap-around
+  REQUIRE(queue.Push(5));
+  for (int expected = 2; expected <= 5; ++expected) {
+    REQUIRE(queue.Pop(value));
+    REQUIRE(value == expected);
+  }
+  REQUIRE_FALSE(queue.Pop(value));
+}
+
+TEST_CASE("queue hands values between two threads", "[threads]")
+{
+  constexpr int count = 100000;
+  SpscQueue<int, 64> queue;
+  std::thread producer(
+      [&queue]
+      {
+        for (int i = 0; i < count; ++i)
+          while (!queue.Push(i))
+            std::this_thread::yield();
+      });
+
+  int next = 0;
+  bool ordered = true;
+  while (next < count) {
+    int value = 0;
+    if (!queue.Pop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    ordered = ordered && value == next;
+    ++next;
+  }
+  producer.join();
+  REQUIRE(ordered);
+}
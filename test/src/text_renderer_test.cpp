@@ -0,0 +1,103 @@
+#include "gl_context.h"
+#include "text_renderer.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+namespace
+{
+// The text of the menu screen: several strings, scales and colors
+void queueMenu(TextRenderer& text)
+{
+  text.RenderText("Lives:3", 5.0f, 5.0f, 1.0f);
+  text.RenderText("Press ENTER to start", 250.0f, 300.0f, 1.0f);
+  text.RenderText("Press W or S to select level", 245.0f, 320.0f, 0.75f);
+  text.RenderText("Press H to toggle Hard Mode: OFF", 225.0f, 340.0f, 0.75f);
+  text.RenderText(
+      "You WON!!!", 320.0f, 280.0f, 1.0f, glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+constexpr unsigned int menuGlyphs = 7 + 20 + 28 + 32 + 10;
+}  // namespace
+
+TEST_CASE("a frame of text renders with one draw call", "[text][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+
+  TextRenderer text(800, 600);
+  text.Load("fonts/OCRAEXT.TTF", 24);
+
+  text.Flush();
+  CHECK(text.GetStats().DrawCalls == 0);
+
+  queueMenu(text);
+  text.Flush();
+  CHECK(text.GetStats().Glyphs == menuGlyphs);
+  CHECK(text.GetStats().DrawCalls == 1);
+  CHECK(text.GetStats().Layouts == 5);
+
+  SECTION("unchanged text isn't laid out again")
+  {
+    queueMenu(text);
+    text.Flush();
+    CHECK(text.GetStats().Glyphs == menuGlyphs);
+    CHECK(text.GetStats().DrawCalls == 1);
+    CHECK(text.GetStats().Layouts == 0);
+
+    // only what changed is
+    text.RenderText("Lives:2", 5.0f, 5.0f, 1.0f);
+    text.RenderText("Press ENTER to start", 250.0f, 300.0f, 1.0f);
+    text.Flush();
+    CHECK(text.GetStats().Layouts == 1);
+  }
+
+  SECTION("changing text doesn't exhaust the buffer")
+  {
+    for (unsigned int frame = 0; frame < 2000; ++frame) {
+      text.RenderText("Frame " + std::to_string(frame), 5.0f, 5.0f, 1.0f);
+      text.Flush();
+      REQUIRE(text.GetStats().DrawCalls == 1);
+    }
+  }
+
+  SECTION("queued text is consumed by the flush")
+  {
+    text.Flush();
+    CHECK(text.GetStats().DrawCalls == 0);
+  }
+
+  REQUIRE(glGetError() == GL_NO_ERROR);
+}
+
+TEST_CASE("menu text CPU cost per frame", "[.benchmark][text][gl]")
+{
+  HeadlessContext context;
+  if (!context) {
+    WARN("No OpenGL context available, skipping");
+    return;
+  }
+
+  TextRenderer text(800, 600);
+  text.Load("fonts/OCRAEXT.TTF", 24);
+
+  text.SetLayoutCache(false);
+  BENCHMARK("laid out every frame")
+  {
+    queueMenu(text);
+    text.Flush();
+  };
+
+  text.SetLayoutCache(true);
+  BENCHMARK("cached layouts")
+  {
+    queueMenu(text);
+    text.Flush();
+  };
+  glFinish();
+}
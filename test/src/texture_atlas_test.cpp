@@ -0,0 +1,97 @@
+#include "texture_atlas.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <vector>
+
+namespace
+{
+bool overlap(const AtlasRect& a, const AtlasRect& b)
+{
+  return a.X < b.X + b.Width && b.X < a.X + a.Width && a.Y < b.Y + b.Height
+      && b.Y < a.Y + a.Height;
+}
+
+bool inside(const AtlasRect& rect, unsigned int width, unsigned int height)
+{
+  return rect.X + rect.Width <= width && rect.Y + rect.Height <= height;
+}
+}  // namespace
+
+TEST_CASE("skyline packer places rectangles without overlap", "[atlas]")
+{
+  SkylinePacker packer(64, 64);
+  std::vector<AtlasRect> placed;
+  // a mix that doesn't tile evenly
+  for (unsigned int i = 0; i < 40; ++i) {
+    const auto rect = packer.Insert(3 + i % 7, 2 + (i * 5) % 9);
+    if (!rect)
+      break;
+    placed.push_back(*rect);
+  }
+  REQUIRE(placed.size() == 40);
+  for (std::size_t i = 0; i < placed.size(); ++i) {
+    REQUIRE(inside(placed[i], 64, 64));
+    for (std::size_t j = i + 1; j < placed.size(); ++j)
+      REQUIRE_FALSE(overlap(placed[i], placed[j]));
+  }
+
+  SECTION("full areas refuse more")
+  {
+    REQUIRE_FALSE(packer.Insert(65, 1));
+    SkylinePacker tiny(4, 4);
+    REQUIRE(tiny.Insert(4, 4));
+    REQUIRE_FALSE(tiny.Insert(1, 1));
+  }
+}
+
+TEST_CASE("the game's textures pack into one atlas", "[atlas]")
+{
+  // background, face, blocks, paddle, particle and the six power-ups
+  std::vector<AtlasRect> sizes {{0, 0, 800, 600},
+                                {0, 0, 512, 512},
+                                {0, 0, 128, 128},
+                                {0, 0, 128, 128},
+                                {0, 0, 512, 128},
+                                {0, 0, 500, 500}};
+  for (int i = 0; i < 6; ++i)
+    sizes.push_back(AtlasRect {0, 0, 512, 128});
+
+  const auto layout = PackAtlas(sizes, 1, 4096);
+  REQUIRE(layout);
+  CHECK(layout->Width == 2048);
+  CHECK(layout->Height == 1024);
+  REQUIRE(layout->Rects.size() == sizes.size());
+  for (std::size_t i = 0; i < sizes.size(); ++i) {
+    REQUIRE(layout->Rects[i].Width == sizes[i].Width);
+    REQUIRE(layout->Rects[i].Height == sizes[i].Height);
+    // the gutter stays inside the atlas and apart from the neighbours
+    const AtlasRect& rect = layout->Rects[i];
+    const AtlasRect padded {
+        rect.X - 1, rect.Y - 1, rect.Width + 2, rect.Height + 2};
+    REQUIRE(rect.X >= 1);
+    REQUIRE(rect.Y >= 1);
+    REQUIRE(inside(padded, layout->Width, layout->Height));
+    for (std::size_t j = i + 1; j < sizes.size(); ++j)
+      REQUIRE_FALSE(overlap(padded, layout->Rects[j]));
+  }
+
+  REQUIRE_FALSE(PackAtlas(sizes, 1, 1024));
+}
+
+TEST_CASE("atlas images are surrounded by their edge pixels", "[atlas]")
+{
+  // a 2x2 image with one colour per pixel, placed at (1, 1) of a 4x4 atlas
+  const std::vector<unsigned char> image {
+      1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4};
+  std::vector<unsigned char> atlas(4 * 4 * 4, 0);
+  CopyIntoAtlas(atlas, 4, image.data(), AtlasRect {1, 1, 2, 2}, 1);
+
+  // every atlas pixel takes the value of the nearest image pixel
+  const unsigned char expected[4][4] = {
+      {1, 1, 2, 2}, {1, 1, 2, 2}, {3, 3, 4, 4}, {3, 3, 4, 4}};
+  for (unsigned int y = 0; y < 4; ++y)
+    for (unsigned int x = 0; x < 4; ++x)
+      for (unsigned int c = 0; c < 4; ++c)
+        REQUIRE(atlas[(y * 4 + x) * 4 + c] == expected[y][x]);
+}
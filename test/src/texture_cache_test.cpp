@@ -0,0 +1,180 @@
+#include "texture_cache.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+// A width x height RGBA image whose pixels all have the given value
+CookedTexture solid(unsigned int width,
+                    unsigned int height,
+                    unsigned char value)
+{
+  return CookedTexture(
+      std::vector<unsigned char>(std::size_t {width} * height * 4, value),
+      width,
+      height);
+}
+
+void writeFile(const fs::path& path, const std::string& contents)
+{
+  std::ofstream(path, std::ios::binary) << contents;
+}
+
+// The images the game packs into its sprite atlas
+std::vector<fs::path> gameTextures()
+{
+  std::vector<fs::path> files;
+  for (const auto& entry : fs::directory_iterator("textures"))
+    files.push_back(entry.path());
+  return files;
+}
+}  // namespace
+
+TEST_CASE("mipmaps halve down to one pixel", "[textures]")
+{
+  // a 4x2 image: left half black, right half white
+  std::vector<unsigned char> pixels(4 * 2 * 4, 0);
+  for (std::size_t y = 0; y < 2; ++y)
+    for (std::size_t x = 2; x < 4; ++x)
+      for (std::size_t c = 0; c < 4; ++c)
+        pixels[(y * 4 + x) * 4 + c] = 255;
+  CookedTexture texture(pixels, 4, 2);
+  texture.GenerateMipmaps();
+
+  const auto& levels = texture.Levels();
+  REQUIRE(levels.size() == 3);
+  REQUIRE(levels[1].Width == 2);
+  REQUIRE(levels[1].Height == 1);
+  REQUIRE(levels[2].Width == 1);
+  REQUIRE(levels[2].Height == 1);
+  // each level averages 2x2 pixels of the one above
+  REQUIRE(texture.Pixels(1)[0] == 0);
+  REQUIRE(texture.Pixels(1)[4] == 255);
+  REQUIRE(texture.Pixels(2)[0] == 128);
+
+  SECTION("odd sizes repeat their last row and column")
+  {
+    CookedTexture odd = solid(5, 3, 40);
+    odd.GenerateMipmaps();
+    REQUIRE(odd.Levels().size() == 3);
+    REQUIRE(odd.Levels()[1].Width == 2);
+    REQUIRE(odd.Levels()[1].Height == 1);
+    REQUIRE(odd.Pixels(2)[3] == 40);
+  }
+}
+
+TEST_CASE("cooked textures are mapped back from the cache", "[textures]")
+{
+  const auto path = fs::temp_directory_path() / "breakout_texture_test.tex";
+  CookedTexture texture = solid(64, 32, 7);
+  texture.GenerateMipmaps();
+  REQUIRE_FALSE(texture.IsMapped());
+  REQUIRE(SaveCookedTexture(texture, 42, path));
+
+  const auto loaded = LoadCookedTexture(42, path);
+  REQUIRE(loaded);
+  REQUIRE(loaded->IsMapped());
+  REQUIRE(loaded->Levels().size() == texture.Levels().size());
+  for (std::size_t i = 0; i < texture.Levels().size(); ++i) {
+    const auto& level = texture.Levels()[i];
+    REQUIRE(loaded->Levels()[i].Width == level.Width);
+    REQUIRE(loaded->Levels()[i].Height == level.Height);
+    const std::size_t bytes = std::size_t {level.Width} * level.Height * 4;
+    REQUIRE(std::equal(texture.Pixels(i),
+                       texture.Pixels(i) + bytes,
+                       loaded->Pixels(i)));
+  }
+
+  SECTION("another key is a miss")
+  {
+    REQUIRE_FALSE(LoadCookedTexture(43, path));
+  }
+
+  SECTION("a truncated file is a miss")
+  {
+    fs::resize_file(path, fs::file_size(path) - 1);
+    REQUIRE_FALSE(LoadCookedTexture(42, path));
+  }
+
+  SECTION("a missing file is a miss")
+  {
+    REQUIRE_FALSE(LoadCookedTexture(42, path.string() + ".missing"));
+  }
+
+  fs::remove(path);
+}
+
+TEST_CASE("cooked texture keys follow the source contents", "[textures]")
+{
+  const auto dir = fs::temp_directory_path();
+  const auto a = dir / "breakout_key_a.png";
+  const auto b = dir / "breakout_key_b.png";
+  writeFile(a, "first image");
+  writeFile(b, "second image");
+
+  const auto key = CookedTextureKey({a, b});
+  REQUIRE(CookedTextureKey({a, b}) == key);
+  REQUIRE(CookedTextureKey({b, a}) != key);
+  REQUIRE(CookedTextureKey({a, b}, 1) != key);
+
+  // same size, one byte different
+  writeFile(b, "second imagf");
+  REQUIRE(CookedTextureKey({a, b}) != key);
+
+  fs::remove(a);
+  fs::remove(b);
+}
+
+TEST_CASE("texture load time with and without the cache",
+          "[.benchmark][textures]")
+{
+  const auto dir = fs::temp_directory_path() / "breakout_texture_bench";
+  fs::create_directories(dir);
+  const auto files = gameTextures();
+  for (const fs::path& file : files) {
+    auto texture = DecodeTexture(file);
+    REQUIRE(texture);
+    texture->GenerateMipmaps();
+    REQUIRE(SaveCookedTexture(*texture,
+                              CookedTextureKey({file}),
+                              dir / file.filename()));
+  }
+
+  BENCHMARK("decode and mipmap " + std::to_string(files.size()) + " images")
+  {
+    std::size_t bytes = 0;
+    for (const fs::path& file : files) {
+      auto texture = DecodeTexture(file);
+      texture->GenerateMipmaps();
+      bytes += texture->Width();
+    }
+    return bytes;
+  };
+
+  BENCHMARK("map " + std::to_string(files.size()) + " cooked images")
+  {
+    // hashing the sources is part of a cache hit; reading every page stands
+    // in for the upload
+    unsigned int sum = 0;
+    for (const fs::path& file : files) {
+      const auto texture =
+          LoadCookedTexture(CookedTextureKey({file}), dir / file.filename());
+      const auto& level = texture->Levels().front();
+      const std::size_t bytes = std::size_t {level.Width} * level.Height * 4;
+      for (std::size_t i = 0; i < bytes; i += 4096)
+        sum += texture->Pixels()[i];
+    }
+    return sum;
+  };
+
+  fs::remove_all(dir);
+}
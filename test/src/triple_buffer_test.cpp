@@ -0,0 +1,62 @@
+#include "triple_buffer.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <thread>
+#include <vector>
+
+TEST_CASE("triple buffer hands over the newest value", "[threads]")
+{
+  TripleBuffer<int> buffer;
+  REQUIRE_FALSE(buffer.Fetch());
+
+  buffer.Back() = 1;
+  buffer.Publish();
+  buffer.Back() = 2;
+  buffer.Publish();
+  // the reader skips straight to the newest value
+  REQUIRE(buffer.Fetch());
+  REQUIRE(buffer.Front() == 2);
+  // and keeps it until another one is published
+  REQUIRE_FALSE(buffer.Fetch());
+  REQUIRE(buffer.Front() == 2);
+
+  buffer.Back() = 3;
+  buffer.Publish();
+  REQUIRE(buffer.Fetch());
+  REQUIRE(buffer.Front() == 3);
+}
+
+TEST_CASE("triple buffer never hands out a torn value", "[threads]")
+{
+  // every element of a published value is the same, so a value the writer
+  // was still filling would show up as a mix
+  constexpr unsigned int count = 20000;
+  TripleBuffer<std::vector<unsigned int>> buffer;
+  std::thread writer(
+      [&buffer]
+      {
+        for (unsigned int i = 1; i <= count; ++i) {
+          buffer.Back().assign(256, i);
+          buffer.Publish();
+        }
+      });
+
+  unsigned int last = 0;
+  bool consistent = true;
+  bool increasing = true;
+  while (last < count) {
+    if (!buffer.Fetch()) {
+      std::this_thread::yield();
+      continue;
+    }
+    const std::vector<unsigned int>& value = buffer.Front();
+    for (unsigned int element : value)
+      consistent = consistent && element == value.front();
+    increasing = increasing && value.front() > last;
+    last = value.front();
+  }
+  writer.join();
+  REQUIRE(consistent);
+  REQUIRE(increasing);
+}